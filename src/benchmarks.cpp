@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define CATCH_CONFIG_MAIN // This tells Catch to provide a main() - only do this in one cpp file
+#define CATCH_CONFIG_ENABLE_BENCHMARKING
+#include "catch.hpp"
+
+#include "steering-detector.hpp"
+#include "steering-output.hpp"
+#include "synthetic-frames.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Every stage of the frame loop on synthetic frames of these sizes; run with
+// "-r xml" for results that can be compared between machines.
+static const std::vector<cv::Size> SIZES{cv::Size(320, 240), cv::Size(640, 480), cv::Size(1280, 720)};
+
+static std::string nameOf(const char *stage, const cv::Size &size) {
+  return std::string{stage} + " " + std::to_string(size.width) + "x" + std::to_string(size.height);
+}
+
+// The input of each stage for one frame, computed with the same calls as ConeSegmentation::detect.
+struct StageInputs {
+  SteeringDetectorConfig config;
+  cv::Mat frame;
+  cv::Mat centre;
+  cv::Mat hsv;
+  cv::Mat mask;
+  cv::Mat morphed;
+
+  explicit StageInputs(const cv::Size &size)
+      : config{SyntheticFrames::config(size)}
+      , frame{SyntheticFrames::frame(size, 0)}
+      , centre{frame(config.regionOfInterestCentre)}
+      , hsv{}
+      , mask{}
+      , morphed{} {
+    cv::cvtColor(centre, hsv, cv::COLOR_BGR2HSV);
+    cv::inRange(hsv, cv::Scalar(config.blue.minHue, config.blue.minSat, config.blue.minValue), cv::Scalar(config.blue.maxHue, config.blue.maxSat, config.blue.maxValue), mask);
+    cv::GaussianBlur(mask, morphed, cv::Size(5, 5), 0);
+    cv::dilate(morphed, morphed, 0);
+    cv::erode(morphed, morphed, 0);
+  }
+};
+
+TEST_CASE("ROI copy", "[roi]") {
+  for (const cv::Size &size : SIZES) {
+    const StageInputs inputs{size};
+    const cv::Rect roi{inputs.config.boundingRegionOfInterest()};
+    cv::Mat copy;
+    BENCHMARK(nameOf("ROI copy", size)) {
+      inputs.frame(roi).copyTo(copy);
+      return copy.data;
+    };
+  }
+}
+
+TEST_CASE("BGR to HSV", "[cvtColor]") {
+  for (const cv::Size &size : SIZES) {
+    const StageInputs inputs{size};
+    cv::Mat hsv;
+    BENCHMARK(nameOf("cvtColor", size)) {
+      cv::cvtColor(inputs.centre, hsv, cv::COLOR_BGR2HSV);
+      return hsv.data;
+    };
+  }
+}
+
+TEST_CASE("HSV threshold", "[inRange]") {
+  for (const cv::Size &size : SIZES) {
+    const StageInputs inputs{size};
+    const HsvRange &range{inputs.config.blue};
+    cv::Mat mask;
+    BENCHMARK(nameOf("inRange", size)) {
+      cv::inRange(inputs.hsv, cv::Scalar(range.minHue, range.minSat, range.minValue), cv::Scalar(range.maxHue, range.maxSat, range.maxValue), mask);
+      return mask.data;
+    };
+  }
+}
+
+TEST_CASE("Blur and morphology", "[blur/morph]") {
+  for (const cv::Size &size : SIZES) {
+    const StageInputs inputs{size};
+    cv::Mat img;
+    BENCHMARK(nameOf("blur/morph", size)) {
+      cv::GaussianBlur(inputs.mask, img, cv::Size(5, 5), 0);
+      cv::dilate(img, img, 0);
+      cv::erode(img, img, 0);
+      return img.data;
+    };
+  }
+}
+
+TEST_CASE("Specialized kernels", "[specialized]") {
+  for (const cv::Size &size : SIZES) {
+    const StageInputs inputs{size};
+    const SpecializedKernels *kernels{PipelineRegistry::find(inputs.centre, inputs.config.blue)};
+    REQUIRE(nullptr != kernels);
+    cv::Mat padded;
+    cv::Mat img;
+    std::vector<uint8_t> scratch;
+    kernels->threshold(inputs.centre, padded);
+    kernels->filter(padded, img, scratch);
+    // The same mask as the generic path, in the time of cvtColor + inRange and blur/morph
+    REQUIRE(0 == cv::countNonZero(img != inputs.morphed));
+    BENCHMARK(nameOf("specialized cvtColor+inRange", size)) {
+      kernels->threshold(inputs.centre, padded);
+      return padded.data;
+    };
+    BENCHMARK(nameOf("specialized blur/morph", size)) {
+      kernels->filter(padded, img, scratch);
+      return img.data;
+    };
+  }
+}
+
+TEST_CASE("Contours and areas", "[findContours]") {
+  for (const cv::Size &size : SIZES) {
+    const StageInputs inputs{size};
+    std::vector<std::vector<cv::Point>> contours;
+    std::vector<cv::Vec4i> hierarchy;
+    cv::Mat img;
+    BENCHMARK(nameOf("findContours", size)) {
+      // findContours may modify its input on older OpenCV versions
+      inputs.morphed.copyTo(img);
+      cv::findContours(img, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
+      double area{0.0};
+      for (const auto &contour : contours) {
+        area += cv::contourArea(contour);
+      }
+      return area;
+    };
+  }
+}
+
+TEST_CASE("Steering decision", "[steering]") {
+  // The controller does not depend on the frame size; a few blobs per channel as on the track
+  const std::vector<double> areas{12.0, 75.5, 640.0, 3.5};
+  SteeringController controller;
+  BENCHMARK("steering") {
+    return controller.update([&areas](ConeChannel) {
+      return BlobAreas{areas.data(), areas.data() + areas.size()};
+    });
+  };
+}
+
+TEST_CASE("Output formatting", "[output]") {
+  const float steeringWheelAngle{0.025f};
+  const float groundSteering{0.0302f};
+  const uint64_t sMicro{1614691245329981};
+  std::ostringstream out;
+  ConsoleSink console{out, false};
+  BENCHMARK("output") {
+    // The overlay text and the line on stdout as in the microservice
+    out.str("");
+    console.write(sMicro, steeringWheelAngle);
+    return OverlaySink::text(steeringWheelAngle, groundSteering, sMicro).size() + out.str().size();
+  };
+}
+
+TEST_CASE("Whole frame", "[frame]") {
+  for (const cv::Size &size : SIZES) {
+    const SteeringDetectorConfig config{SyntheticFrames::config(size)};
+    std::vector<cv::Mat> frames;
+    for (uint32_t i{0}; i < 16; i++) {
+      frames.push_back(SyntheticFrames::frame(size, i));
+    }
+
+    // The detection must see the cones, or the numbers would not be representative
+    ConeSegmentation segmentation;
+    REQUIRE(!segmentation.detect(frames[0](config.regionOfInterestCentre), config.blue, false).empty());
+    REQUIRE(!segmentation.detect(frames[0](config.regionOfInterestCentre), config.yellow, false).empty());
+    REQUIRE(!segmentation.detect(frames[0](config.regionOfInterestRight), config.yellow, false).empty());
+
+    SteeringDetector detector{config};
+    uint32_t i{0};
+    BENCHMARK(nameOf("frame", size)) {
+      return detector.process(frames[i++ % frames.size()]);
+    };
+  }
+}
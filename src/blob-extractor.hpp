@@ -0,0 +1,62 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef BLOB_EXTRACTOR_HPP
+#define BLOB_EXTRACTOR_HPP
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cstddef>
+#include <vector>
+
+// Areas of the blobs found in one channel, in the order of findContours.
+struct BlobAreas {
+  const double *first;
+  const double *last;
+
+  const double *begin() const noexcept {
+    return first;
+  }
+  const double *end() const noexcept {
+    return last;
+  }
+};
+
+// Turns the contours of a segmented region into the areas of its blobs.
+class BlobExtractor {
+ public:
+  // Areas of contours, multiplied by scale for regions that were segmented at
+  // a lower resolution; valid until the next call.
+  BlobAreas extract(const std::vector<std::vector<cv::Point>> &contours, double scale = 1.0) {
+    m_areas.clear();
+    for (const auto &contour : contours) {
+      m_areas.push_back(cv::contourArea(contour) * scale);
+    }
+    return BlobAreas{m_areas.data(), m_areas.data() + m_areas.size()};
+  }
+
+  // Make room for blobs so that extracting them does not allocate.
+  void reserve(std::size_t blobs) {
+    m_areas.reserve(blobs);
+  }
+
+ private:
+  // Reused between regions to avoid reallocations
+  std::vector<double> m_areas{};
+};
+
+#endif
@@ -0,0 +1,296 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CHROME_TRACE_HPP
+#define CHROME_TRACE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#ifdef STAGE_PROFILING
+
+#include <unistd.h>
+
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// Records spans of all threads and writes them in the Chrome trace event
+// format, which chrome://tracing and ui.perfetto.dev open.
+//
+// Every thread appends to its own buffer, so recording takes neither a lock
+// nor a shared cache line: the thread writes the event and then publishes it
+// by increasing the size of its buffer with release semantics; dump() reads
+// every buffer up to its published size. A full buffer drops further events
+// and counts them, so that the trace of the first minutes stays complete.
+class Tracer {
+ public:
+  static constexpr uint32_t MAX_THREADS{64};
+  static constexpr uint32_t EVENTS_PER_THREAD{1u << 18}; // 6 MiB per thread, about 5 minutes at 30 frames per second
+
+ public:
+  static Tracer &instance() noexcept {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  Tracer(const Tracer &) = delete;
+  Tracer &operator=(const Tracer &) = delete;
+
+  // Record spans from now on and write them to file on dump().
+  void start(const std::string &file) {
+    m_file = file;
+    m_origin = std::chrono::steady_clock::now();
+    m_enabled.store(true, std::memory_order_release);
+  }
+
+  bool enabled() const noexcept {
+    return m_enabled.load(std::memory_order_acquire);
+  }
+
+  // Name the calling thread in the trace; name must be a string literal. Has
+  // no effect before start().
+  void nameThisThread(const char *name) noexcept {
+    Buffer *buffer{thisThreadsBuffer()};
+    if (nullptr != buffer) {
+      buffer->name.store(name, std::memory_order_release);
+    }
+  }
+
+  void record(const char *name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end) noexcept {
+    Buffer *buffer{thisThreadsBuffer()};
+    if (nullptr == buffer) {
+      return;
+    }
+    const uint32_t size{buffer->size.load(std::memory_order_relaxed)};
+    if (EVENTS_PER_THREAD <= size) {
+      buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    Event &event{buffer->events[size]};
+    event.name = name;
+    event.begin = std::chrono::duration_cast<std::chrono::nanoseconds>(begin - m_origin).count();
+    event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    buffer->size.store(size + 1, std::memory_order_release);
+  }
+
+  // Write all spans recorded so far; may be called repeatedly while other
+  // threads keep recording.
+  bool dump() {
+    const std::string tmpFile{m_file + ".tmp"};
+    uint64_t dropped{0};
+    {
+      std::ofstream out(tmpFile, std::ios::out | std::ios::trunc);
+      const long pid{static_cast<long>(::getpid())};
+      const char *separator{""};
+      out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+      out << std::fixed << std::setprecision(3);
+      // Not std::min, which would odr-use MAX_THREADS and need a definition at -O0
+      const uint32_t registered{m_numberOfBuffers.load(std::memory_order_acquire)};
+      const uint32_t numberOfBuffers{(registered < MAX_THREADS) ? registered : MAX_THREADS};
+      for (uint32_t i{0}; i < numberOfBuffers; i++) {
+        const Buffer *buffer{m_buffers[i].load(std::memory_order_acquire)};
+        if (nullptr == buffer) {
+          continue;
+        }
+        const uint32_t tid{i + 1};
+        out << separator << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid << ",\"args\":{\"name\":\"";
+        const char *name{buffer->name.load(std::memory_order_acquire)};
+        writeEscaped(out, (nullptr != name) ? name : "thread");
+        out << "\"}}";
+        separator = ",";
+        const uint32_t size{buffer->size.load(std::memory_order_acquire)};
+        for (uint32_t j{0}; j < size; j++) {
+          const Event &event{buffer->events[j]};
+          out << ",\n{\"name\":\"";
+          writeEscaped(out, event.name);
+          out << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid << ",\"ts\":" << static_cast<double>(event.begin) / 1e3
+              << ",\"dur\":" << static_cast<double>(event.duration) / 1e3 << "}";
+        }
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+      }
+      out << "\n]}\n";
+      out.flush();
+      if (!out.good()) {
+        std::remove(tmpFile.c_str());
+        return false;
+      }
+    }
+    if (0 < dropped) {
+      std::clog << "trace: " << dropped << " spans were dropped as the buffers were full" << std::endl;
+    }
+    return 0 == std::rename(tmpFile.c_str(), m_file.c_str());
+  }
+
+  // SIGUSR1 asks for a dump, SIGINT and SIGTERM ask to stop; a second SIGINT
+  // or SIGTERM terminates as usual in case the frame loop does not get there.
+  static void installSignalHandlers() noexcept {
+    struct sigaction action;
+    std::memset(&action, 0, sizeof(action));
+    sigemptyset(&action.sa_mask);
+    action.sa_handler = &onSignal;
+    ::sigaction(SIGUSR1, &action, nullptr);
+    action.sa_flags = SA_RESETHAND;
+    ::sigaction(SIGINT, &action, nullptr);
+    ::sigaction(SIGTERM, &action, nullptr);
+  }
+
+  // Return true once after SIGUSR1.
+  static bool dumpRequested() noexcept {
+    const bool retVal{0 != signalFlags().dump};
+    signalFlags().dump = 0;
+    return retVal;
+  }
+
+  static bool stopRequested() noexcept {
+    return 0 != signalFlags().stop;
+  }
+
+ private:
+  struct Event {
+    const char *name;
+    int64_t begin;
+    int64_t duration;
+  };
+
+  struct Buffer {
+    std::atomic<const char *> name{nullptr};
+    std::atomic<uint32_t> size{0};
+    std::atomic<uint64_t> dropped{0};
+    Event events[EVENTS_PER_THREAD];
+  };
+
+  struct SignalFlags {
+    volatile std::sig_atomic_t dump;
+    volatile std::sig_atomic_t stop;
+  };
+
+ private:
+  Tracer() noexcept
+      : m_file{}
+      , m_origin{std::chrono::steady_clock::now()} {}
+
+  // Buffers are never freed: threads of the middleware may still record while
+  // the process exits. A thread gets its buffer only once tracing was started,
+  // so that a build with STAGE_PROFILING run without a trace allocates (and
+  // with --mlock locks) nothing.
+  Buffer *thisThreadsBuffer() noexcept {
+    thread_local Buffer *buffer{nullptr};
+    thread_local bool registered{false};
+    if (!registered && enabled()) {
+      registered = true;
+      const uint32_t index{m_numberOfBuffers.fetch_add(1, std::memory_order_acq_rel)};
+      if (index < MAX_THREADS) {
+        buffer = new Buffer;
+        m_buffers[index].store(buffer, std::memory_order_release);
+      }
+    }
+    return buffer;
+  }
+
+  static void writeEscaped(std::ostream &out, const char *s) {
+    for (; '\0' != *s; s++) {
+      if (('"' == *s) || ('\\' == *s)) {
+        out << '\\';
+      }
+      out << (static_cast<unsigned char>(*s) < 0x20 ? ' ' : *s);
+    }
+  }
+
+  static SignalFlags &signalFlags() noexcept {
+    static SignalFlags flags{0, 0};
+    return flags;
+  }
+
+  static void onSignal(int signal) {
+    if (SIGUSR1 == signal) {
+      signalFlags().dump = 1;
+    } else {
+      signalFlags().stop = 1;
+    }
+  }
+
+ private:
+  std::string m_file;
+  std::chrono::steady_clock::time_point m_origin;
+  std::atomic<bool> m_enabled{false};
+  std::atomic<uint32_t> m_numberOfBuffers{0};
+  std::atomic<Buffer *> m_buffers[MAX_THREADS] = {};
+};
+
+// Records the time from its construction to its destruction as a span of the
+// calling thread if tracing was started.
+class TraceSpan {
+ public:
+  explicit TraceSpan(const char *name) noexcept
+      : m_name{Tracer::instance().enabled() ? name : nullptr}
+      , m_begin{(nullptr != m_name) ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point{}} {}
+
+  ~TraceSpan() {
+    if (nullptr != m_name) {
+      Tracer::instance().record(m_name, m_begin, std::chrono::steady_clock::now());
+    }
+  }
+
+  TraceSpan(const TraceSpan &) = delete;
+  TraceSpan &operator=(const TraceSpan &) = delete;
+
+ private:
+  const char *m_name;
+  std::chrono::steady_clock::time_point m_begin;
+};
+
+#else
+
+// Built without STAGE_PROFILING: the same interface, compiled to nothing.
+class Tracer {
+ public:
+  static Tracer &instance() noexcept {
+    static Tracer tracer;
+    return tracer;
+  }
+
+  void start(const std::string &) noexcept {}
+  bool enabled() const noexcept {
+    return false;
+  }
+  void nameThisThread(const char *) noexcept {}
+  bool dump() noexcept {
+    return false;
+  }
+  static void installSignalHandlers() noexcept {}
+  static bool dumpRequested() noexcept {
+    return false;
+  }
+  static bool stopRequested() noexcept {
+    return false;
+  }
+};
+
+class TraceSpan {
+ public:
+  explicit TraceSpan(const char *) noexcept {}
+};
+
+#endif
+
+#endif
@@ -6099,13 +6099,33 @@ class LIBCLUON_API TerminateHandler {
 
 #include <atomic>
 #include <condition_variable>
-#include <deque>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <memory>
 #include <mutex>
+#include <new>
 #include <thread>
 
 namespace cluon {
 
+/**
+ * Behavior of NotifyingPipeline::add when the pipeline is full.
+ */
+enum class PipelineBackpressure : uint8_t {
+    DROP_OLDEST = 0, // Discard the oldest queued entry to make room.
+    BLOCK       = 1, // Wait until the pipeline's thread has made room.
+};
+
+/**
+This class hands over entries from one or more producers to a delegate that is
+called from a separate thread. The entries are kept in a bounded, lock-free
+ring buffer (D. Vyukov's bounded MPMC queue with per-slot sequence numbers);
+entries are moved in and out, hence move-only types are supported. The
+pipeline's thread drains all available entries per wake-up; the mutex and
+condition variable are only used to put the pipeline's thread to sleep when
+the ring buffer is empty.
+*/
 template <class T>
 class LIBCLUON_API NotifyingPipeline {
    private:
@@ -6115,8 +6135,31 @@ class LIBCLUON_API NotifyingPipeline {
     NotifyingPipeline &operator=(NotifyingPipeline &&) = delete;
 
    public:
-    NotifyingPipeline(std::function<void(T &&)> delegate)
-        : m_delegate(delegate) {
+    /**
+     * Constructor.
+     *
+     * @param delegate Function to call for every entry.
+     * @param capacity Maximum number of queued entries (rounded up to a power of two).
+     * @param backpressure Behavior of add() when the pipeline is full.
+     */
+    NotifyingPipeline(std::function<void(T &&)> delegate,
+                      std::size_t capacity              = 1024,
+                      PipelineBackpressure backpressure = PipelineBackpressure::BLOCK)
+        : m_delegate(delegate)
+        , m_backpressure(backpressure) {
+        m_capacity = 2;
+        while (m_capacity < capacity) { m_capacity <<= 1; }
+        m_mask  = m_capacity - 1;
+        m_slots = std::unique_ptr<Slot[]>(new Slot[m_capacity]);
+
+        // Before C++17, new does not honor alignas(64); align the positions by hand.
+        std::size_t space{sizeof(Positions) + alignof(Positions)};
+        m_positionsStorage = std::unique_ptr<unsigned char[]>(new unsigned char[space]);
+        void *positions{m_positionsStorage.get()};
+        std::align(alignof(Positions), sizeof(Positions), positions, space);
+        m_positions = new (positions) Positions{};
+        for (std::size_t i{0}; i < m_capacity; i++) { m_slots[i].m_sequence.store(i, std::memory_order_relaxed); }
+
         m_pipelineThread = std::thread(&NotifyingPipeline::processPipeline, this);
 
         // Let the operating system spawn the thread.
@@ -6128,7 +6171,10 @@ class LIBCLUON_API NotifyingPipeline {
         m_pipelineThreadRunning.store(false);
 
         // Wake any waiting threads.
-        m_pipelineCondition.notify_all();
+        {
+            std::lock_guard<std::mutex> lck(m_pipelineMutex);
+            m_pipelineCondition.notify_all();
+        }
 
         // Joining the thread could fail.
         try {
@@ -6136,68 +6182,176 @@ class LIBCLUON_API NotifyingPipeline {
                 m_pipelineThread.join();
             }
         } catch (...) {} // LCOV_EXCL_LINE
+        m_positions->~Positions();
     }
 
    public:
-    inline void add(T &&entry) noexcept {
-        std::unique_lock<std::mutex> lck(m_pipelineMutex);
-        m_pipeline.emplace_back(entry);
+    /**
+     * This method moves an entry into the pipeline; notifyAll() needs to be
+     * called afterwards to wake up the pipeline's thread. Several entries
+     * can be added before notifying to have them processed as one batch.
+     *
+     * @param entry Entry to be processed.
+     * @return true if the entry was queued; false if the pipeline is stopping.
+     */
+    inline bool add(T &&entry) noexcept {
+        bool retVal{false};
+        while (!retVal && m_pipelineThreadRunning.load(std::memory_order_relaxed)) {
+            retVal = tryPush(entry);
+            if (!retVal) {
+                if (PipelineBackpressure::DROP_OLDEST == m_backpressure) {
+                    T oldest;
+                    if (tryPop(oldest)) {
+                        m_positions->m_droppedEntries.fetch_add(1, std::memory_order_relaxed);
+                    }
+                } else {
+                    // Make sure that the pipeline's thread is draining and sleep
+                    // until it has made room; it notifies after every entry
+                    // while producers are blocked.
+                    notifyAll();
+                    m_blockedProducers.fetch_add(1);
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    {
+                        std::unique_lock<std::mutex> lck(m_pipelineMutex);
+                        m_pipelineCondition.wait(lck, [this] { return (!this->m_pipelineThreadRunning.load() || !this->isFull()); });
+                    }
+                    m_blockedProducers.fetch_sub(1);
+                }
+            }
+        }
+        return retVal;
     }
 
-    inline void notifyAll() noexcept { m_pipelineCondition.notify_all(); }
+    inline void notifyAll() noexcept {
+        // Only take the mutex when the pipeline's thread is about to sleep.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_pipelineThreadSleeping.load()) {
+            std::lock_guard<std::mutex> lck(m_pipelineMutex);
+            m_pipelineCondition.notify_all();
+        }
+    }
 
     inline bool isRunning() noexcept { return m_pipelineThreadRunning.load(); }
 
+    /**
+     * @return Number of entries that were discarded due to PipelineBackpressure::DROP_OLDEST.
+     */
+    inline uint64_t droppedEntries() const noexcept { return m_positions->m_droppedEntries.load(std::memory_order_relaxed); }
+
    private:
+    inline bool tryPush(T &entry) noexcept {
+        std::size_t pos{m_positions->m_enqueuePosition.load(std::memory_order_relaxed)};
+        for (;;) {
+            Slot &slot{m_slots[pos & m_mask]};
+            const std::size_t SEQUENCE{slot.m_sequence.load(std::memory_order_acquire)};
+            const std::ptrdiff_t DIFF{static_cast<std::ptrdiff_t>(SEQUENCE) - static_cast<std::ptrdiff_t>(pos)};
+            if (0 == DIFF) {
+                if (m_positions->m_enqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.m_entry = std::move(entry);
+                    slot.m_sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (0 > DIFF) {
+                return false; // Full.
+            } else {
+                pos = m_positions->m_enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    inline bool tryPop(T &entry) noexcept {
+        std::size_t pos{m_positions->m_dequeuePosition.load(std::memory_order_relaxed)};
+        for (;;) {
+            Slot &slot{m_slots[pos & m_mask]};
+            const std::size_t SEQUENCE{slot.m_sequence.load(std::memory_order_acquire)};
+            const std::ptrdiff_t DIFF{static_cast<std::ptrdiff_t>(SEQUENCE) - static_cast<std::ptrdiff_t>(pos + 1)};
+            if (0 == DIFF) {
+                if (m_positions->m_dequeuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    entry = std::move(slot.m_entry);
+                    slot.m_entry = T{};
+                    slot.m_sequence.store(pos + m_capacity, std::memory_order_release);
+                    return true;
+                }
+            } else if (0 > DIFF) {
+                return false; // Empty.
+            } else {
+                pos = m_positions->m_dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    inline bool isFull() const noexcept {
+        const std::size_t POS{m_positions->m_enqueuePosition.load(std::memory_order_relaxed)};
+        const std::size_t SEQUENCE{m_slots[POS & m_mask].m_sequence.load(std::memory_order_acquire)};
+        return (0 > static_cast<std::ptrdiff_t>(SEQUENCE) - static_cast<std::ptrdiff_t>(POS));
+    }
+
+    inline bool isEmpty() const noexcept {
+        const std::size_t POS{m_positions->m_dequeuePosition.load(std::memory_order_relaxed)};
+        return (m_slots[POS & m_mask].m_sequence.load(std::memory_order_acquire) != POS + 1);
+    }
+
     inline void processPipeline() noexcept {
         // Indicate to caller that we are ready.
         m_pipelineThreadRunning.store(true);
 
+        T entry;
         while (m_pipelineThreadRunning.load()) {
-            std::unique_lock<std::mutex> lck(m_pipelineMutex);
-            // Wait until the thread should stop or data is available.
-            m_pipelineCondition.wait(lck, [this] { return (!this->m_pipelineThreadRunning.load() || !this->m_pipeline.empty()); });
-
-            // The condition will automatically lock the mutex after waking up.
-            // As we are locking per entry, we need to unlock the mutex first.
-            lck.unlock();
-
-            uint32_t entries{0};
-            {
-                lck.lock();
-                entries = static_cast<uint32_t>(m_pipeline.size());
-                lck.unlock();
-            }
-            for (uint32_t i{0}; i < entries; i++) {
-                T entry;
-                {
-                    lck.lock();
-                    entry = m_pipeline.front();
-                    lck.unlock();
+            // Drain all entries that are available.
+            while (m_pipelineThreadRunning.load(std::memory_order_relaxed) && tryPop(entry)) {
+                // Wake producers that wait for room; the fence pairs with theirs.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (0 < m_blockedProducers.load()) {
+                    std::lock_guard<std::mutex> lck(m_pipelineMutex);
+                    m_pipelineCondition.notify_all();
                 }
-
                 if (nullptr != m_delegate) {
                     m_delegate(std::move(entry));
                 }
+            }
 
-                {
-                    lck.lock();
-                    m_pipeline.pop_front();
-                    lck.unlock();
-                }
+            // Announce that we are going to sleep before checking for new
+            // entries once more so that a concurrent notifyAll() is not lost.
+            m_pipelineThreadSleeping.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lck(m_pipelineMutex);
+                // Wait until the thread should stop or data is available.
+                m_pipelineCondition.wait(lck, [this] { return (!this->m_pipelineThreadRunning.load() || !this->isEmpty()); });
             }
+            m_pipelineThreadSleeping.store(false);
         }
     }
 
    private:
+    class Slot {
+       public:
+        std::atomic<std::size_t> m_sequence{0};
+        T m_entry{};
+    };
+
     std::function<void(T &&)> m_delegate;
+    PipelineBackpressure m_backpressure{PipelineBackpressure::BLOCK};
+
+    std::size_t m_capacity{0};
+    std::size_t m_mask{0};
+    std::unique_ptr<Slot[]> m_slots{};
+
+    // Positions of producers and consumer on separate cache lines.
+    struct Positions {
+        alignas(64) std::atomic<std::size_t> m_enqueuePosition{0};
+        alignas(64) std::atomic<std::size_t> m_dequeuePosition{0};
+        alignas(64) std::atomic<uint64_t> m_droppedEntries{0};
+    };
+    std::unique_ptr<unsigned char[]> m_positionsStorage{};
+    Positions *m_positions{nullptr};
+    std::atomic<uint32_t> m_blockedProducers{0};
 
     std::atomic<bool> m_pipelineThreadRunning{false};
+    std::atomic<bool> m_pipelineThreadSleeping{false};
     std::thread m_pipelineThread{};
     std::mutex m_pipelineMutex{};
     std::condition_variable m_pipelineCondition{};
-
-    std::deque<T> m_pipeline{};
 };
 } // namespace cluon
 
@@ -6274,6 +6428,7 @@ namespace cluon {
 #include <mutex>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace cluon {
 /**
@@ -6328,6 +6483,15 @@ class LIBCLUON_API UDPSender {
      */
     std::pair<ssize_t, int32_t> send(std::string &&data) const noexcept;
 
+    /**
+     * Send the given strings as individual datagrams; on Linux, they are
+     * handed over to the kernel using as few sendmmsg calls as possible.
+     *
+     * @param datagrams Data to send; one datagram per entry.
+     * @return Pair: Number of bytes sent and errno of the last failure.
+     */
+    std::pair<ssize_t, int32_t> sendBatch(std::vector<std::string> &&datagrams) const noexcept;
+
    public:
     /**
      * @return Port that this UDP sender will use for sending or 0 if no information available.
@@ -6413,6 +6577,12 @@ activated and concurrently waiting for data in a separate thread. To check
 whether the instance was created successfully and running, the method
 `isRunning()` should be called.
 
+On Linux, the receiving thread sleeps in `epoll_wait` without timeout and
+drains the socket in batches using `recvmmsg`; the kernel's receive time stamp
+is taken from the `SO_TIMESTAMPNS` ancillary data of each datagram. The
+human-readable sender representation is only formatted when a datagram
+arrives from a different sender than the previous one.
+
 A complete example is available
 [here](https://github.com/chrberger/libcluon/blob/master/libcluon/examples/cluon-UDPReceiver.cpp).
 */
@@ -6453,8 +6623,20 @@ class LIBCLUON_API UDPReceiver {
 
     void readFromSocket() noexcept;
 
+    /**
+     * @return true if the given sender is this process' own sending socket.
+     */
+    bool isSentFromUs(const struct sockaddr_in &remote) const noexcept;
+
+    /**
+     * @return Human-readable representation (X.Y.Z.W:ABCD) of the given sender.
+     */
+    const std::string &formatSender(const struct sockaddr_in &remote) noexcept;
+
    private:
     int32_t m_socket{-1};
+    int32_t m_epollFD{-1};
+    int32_t m_wakeupFD{-1};
     bool m_isBlockingSocket{true};
     std::set<unsigned long> m_listOfLocalIPAddresses{};
     uint16_t m_localSendFromPort;
@@ -6471,12 +6653,16 @@ class LIBCLUON_API UDPReceiver {
    private:
     class PipelineEntry {
        public:
-        std::string m_data;
-        std::string m_from;
-        std::chrono::system_clock::time_point m_sampleTime;
+        std::string m_data{};
+        struct sockaddr_in m_from {};
+        std::chrono::system_clock::time_point m_sampleTime{};
     };
 
     std::shared_ptr<cluon::NotifyingPipeline<PipelineEntry>> m_pipeline{};
+
+    // Last formatted sender; only accessed from the pipeline's thread.
+    struct sockaddr_in m_lastFromAddress {};
+    std::string m_lastFrom{};
 };
 } // namespace cluon
 
@@ -6767,12 +6953,14 @@ namespace cluon {
 //#include "cluon/cluon.hpp"
 
 #include <cstdint>
-#include <sstream>
 #include <string>
 
 namespace cluon {
 /**
-This class encodes a given message in Proto format.
+This class encodes a given message in Proto format. The bytes are appended to
+a contiguous buffer that is either owned by this instance or supplied by the
+caller to reuse its capacity across messages. Nested messages are encoded in
+place into the same buffer; their length prefix is back-patched afterwards.
 */
 class LIBCLUON_API ToProtoVisitor {
    private:
@@ -6782,14 +6970,31 @@ class LIBCLUON_API ToProtoVisitor {
     ToProtoVisitor &operator=(ToProtoVisitor &&) = delete;
 
    public:
-    ToProtoVisitor()  = default;
+    ToProtoVisitor() noexcept;
     ~ToProtoVisitor() = default;
 
+    /**
+     * Constructor to encode into a caller-supplied buffer.
+     *
+     * @param out Buffer to which the encoded bytes are appended.
+     */
+    explicit ToProtoVisitor(std::string &out) noexcept;
+
     /**
      * @return Encoded data in Proto format.
      */
     std::string encodedData() const noexcept;
 
+    /**
+     * @return Number of bytes encoded by this instance.
+     */
+    std::size_t encodedSize() const noexcept;
+
+    /**
+     * This method discards the bytes encoded by this instance to reuse the buffer.
+     */
+    void reset() noexcept;
+
    public:
     // The following methods are provided to allow an instance of this class to
     // be used as visitor for an instance with the method signature void accept<T>(T&);
@@ -6816,25 +7021,41 @@ class LIBCLUON_API ToProtoVisitor {
         (void)typeName;
         (void)name;
 
-        toVarInt(m_buffer, std::move(encodeKey(id, static_cast<uint8_t>(ProtoConstants::LENGTH_DELIMITED))));
-        cluon::ToProtoVisitor nestedProtoEncoder;
-        value.accept(nestedProtoEncoder);
-        encode(m_buffer, std::move(nestedProtoEncoder.encodedData()));
+        toVarInt(m_buffer, encodeKey(id, static_cast<uint8_t>(ProtoConstants::LENGTH_DELIMITED)));
+        // Reserve one byte for the length prefix, encode the nested message
+        // directly behind it, and back-patch the actual length afterwards.
+        const std::size_t LENGTH_POSITION{m_buffer.size()};
+        m_buffer.push_back('\0');
+        {
+            cluon::ToProtoVisitor nestedProtoEncoder{m_buffer};
+            value.accept(nestedProtoEncoder);
+        }
+        backPatchLength(LENGTH_POSITION, m_buffer.size() - LENGTH_POSITION - 1);
     }
 
    private:
-    std::size_t encode(std::ostream &o, bool &v) noexcept;
-    std::size_t encode(std::ostream &o, int8_t &v) noexcept;
-    std::size_t encode(std::ostream &o, uint8_t &v) noexcept;
-    std::size_t encode(std::ostream &o, int16_t &v) noexcept;
-    std::size_t encode(std::ostream &o, uint16_t &v) noexcept;
-    std::size_t encode(std::ostream &o, int32_t &v) noexcept;
-    std::size_t encode(std::ostream &o, uint32_t &v) noexcept;
-    std::size_t encode(std::ostream &o, int64_t &v) noexcept;
-    std::size_t encode(std::ostream &o, uint64_t &v) noexcept;
-    std::size_t encode(std::ostream &o, float &v) noexcept;
-    std::size_t encode(std::ostream &o, double &v) noexcept;
-    std::size_t encode(std::ostream &o, const std::string &v) noexcept;
+    std::size_t encode(std::string &o, bool &v) noexcept;
+    std::size_t encode(std::string &o, int8_t &v) noexcept;
+    std::size_t encode(std::string &o, uint8_t &v) noexcept;
+    std::size_t encode(std::string &o, int16_t &v) noexcept;
+    std::size_t encode(std::string &o, uint16_t &v) noexcept;
+    std::size_t encode(std::string &o, int32_t &v) noexcept;
+    std::size_t encode(std::string &o, uint32_t &v) noexcept;
+    std::size_t encode(std::string &o, int64_t &v) noexcept;
+    std::size_t encode(std::string &o, uint64_t &v) noexcept;
+    std::size_t encode(std::string &o, float &v) noexcept;
+    std::size_t encode(std::string &o, double &v) noexcept;
+    std::size_t encode(std::string &o, const std::string &v) noexcept;
+
+    /**
+     * This method writes the VarInt-encoded length of a nested message into
+     * the one byte reserved at position; longer VarInts shift the nested
+     * message to the back.
+     *
+     * @param position Position of the reserved byte.
+     * @param length Length of the nested message.
+     */
+    void backPatchLength(std::size_t position, std::size_t length) noexcept;
 
    private:
     uint8_t toZigZag8(int8_t v) noexcept;
@@ -6845,11 +7066,11 @@ class LIBCLUON_API ToProtoVisitor {
     /**
      * This method encodes a given value in VarInt.
      *
-     * @param out std::ostream to encode to.
+     * @param out Buffer to encode to.
      * @param v Value to encode.
      * @return Bytes written.
      */
-    std::size_t toVarInt(std::ostream &out, uint64_t v) noexcept;
+    std::size_t toVarInt(std::string &out, uint64_t v) noexcept;
 
     /**
      * This method creates a key/value pair encoded in Proto format.
@@ -6877,7 +7098,9 @@ class LIBCLUON_API ToProtoVisitor {
     uint64_t encodeKey(uint32_t fieldIdentifier, uint8_t protoType) noexcept;
 
    private:
-    std::stringstream m_buffer{""};
+    std::string m_ownBuffer{};
+    std::string &m_buffer;
+    std::size_t m_begin{0};
 };
 } // namespace cluon
 
@@ -6899,10 +7122,13 @@ class LIBCLUON_API ToProtoVisitor {
 
 #include <cstdint>
 #include <cstddef>
+#include <algorithm>
 #include <array>
+#include <cstring>
 #include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace cluon {
@@ -6956,9 +7182,8 @@ class LIBCLUON_API FromProtoVisitor {
         (void)name;
 
         if (m_callToDecodeFromWithDirectVisit) {
-            std::stringstream sstr{std::move(std::string(m_stringValue.data(), static_cast<std::size_t>(m_value)))};
             cluon::FromProtoVisitor nestedProtoDecoder;
-            nestedProtoDecoder.decodeFrom(sstr, v);
+            nestedProtoDecoder.decodeFrom(m_lengthDelimitedData, static_cast<std::size_t>(m_value), v);
         }
         else if (0 < m_mapOfKeyValues.count(id)) {
             try {
@@ -7017,6 +7242,7 @@ class LIBCLUON_API FromProtoVisitor {
                             m_stringValue.reserve(BYTES_TO_READ_FROM_STREAM);
                         }
                         readBytesFromStream(in, BYTES_TO_READ_FROM_STREAM, m_stringValue.data());
+                        m_lengthDelimitedData = m_stringValue.data();
                         v.accept(m_fieldId, *this);
                     }
                     break;
@@ -7026,6 +7252,91 @@ class LIBCLUON_API FromProtoVisitor {
         m_callToDecodeFromWithDirectVisit = false;
     }
 
+    /**
+     * This method decodes a given buffer into corresponding fields of v. The
+     * bytes are parsed in place: neither an intermediate stream nor a copy
+     * of length-delimited fields is created.
+     *
+     * @param data Pointer to the Proto-encoded bytes.
+     * @param size Number of bytes to decode.
+     * @param v Data structure to receive the decoded values.
+     * @return true if the buffer could be decoded completely.
+     */
+    template<typename T>
+    bool decodeFrom(const char *data, std::size_t size, T &v) noexcept {
+        bool retVal{(nullptr != data) || (0 == size)};
+        const char *cursor{data};
+        const char *const END{data + size};
+
+        m_callToDecodeFromWithDirectVisit = true;
+        while (retVal && (cursor < END)) {
+            const char *valueBegin{nullptr};
+            retVal = nextField(cursor, END, valueBegin);
+            if (retVal) {
+                loadValue(valueBegin);
+                v.accept(m_fieldId, *this);
+            }
+        }
+        m_callToDecodeFromWithDirectVisit = false;
+        m_lengthDelimitedData = nullptr;
+        return retVal;
+    }
+
+    /**
+     * This method builds an index of the fields contained in a given buffer
+     * without decoding any of them; single fields are decoded on demand
+     * afterwards using decodeField(...). The buffer is not copied and must
+     * outlive the index.
+     *
+     * @param data Pointer to the Proto-encoded bytes.
+     * @param size Number of bytes to index.
+     * @return true if the buffer could be indexed completely.
+     */
+    bool indexFrom(const char *data, std::size_t size) noexcept;
+
+    /**
+     * @param fieldId Field identifier to look up.
+     * @return true if the indexed buffer contains the given field.
+     */
+    bool hasField(uint32_t fieldId) const noexcept;
+
+    /**
+     * @return Field identifiers from the indexed buffer in encoded order.
+     */
+    std::vector<uint32_t> indexedFields() const noexcept;
+
+    /**
+     * This method decodes a single field from the buffer indexed by
+     * indexFrom(...) into the corresponding field of v; all other fields of
+     * v remain untouched. For fields that occur more than once, the last
+     * occurrence wins like in a complete decode.
+     *
+     * @param fieldId Field identifier to decode.
+     * @param v Data structure to receive the decoded value.
+     * @return true if the field was present in the indexed buffer.
+     */
+    template<typename T>
+    bool decodeField(uint32_t fieldId, T &v) noexcept {
+        bool retVal{false};
+        for (auto it = m_fieldIndex.rbegin(); it != m_fieldIndex.rend(); it++) {
+            if (fieldId == it->fieldId) {
+                m_fieldId   = it->fieldId;
+                m_protoType = it->protoType;
+                m_value     = it->value;
+                loadValue(it->valueBegin);
+
+                m_callToDecodeFromWithDirectVisit = true;
+                v.accept(m_fieldId, *this);
+                m_callToDecodeFromWithDirectVisit = false;
+                m_lengthDelimitedData = nullptr;
+
+                retVal = true;
+                break;
+            }
+        }
+        return retVal;
+    }
+
    private:
     int8_t fromZigZag8(uint8_t v) noexcept;
     int16_t fromZigZag16(uint16_t v) noexcept;
@@ -7033,6 +7344,25 @@ class LIBCLUON_API FromProtoVisitor {
     int64_t fromZigZag64(uint64_t v) noexcept;
 
     std::size_t fromVarInt(std::istream &in, uint64_t &value) noexcept;
+    std::size_t fromVarInt(const char *&cursor, const char *end, uint64_t &value) noexcept;
+
+    /**
+     * This method reads the key of the next field and skips over its value.
+     *
+     * @param cursor Position in the buffer; advanced behind the field.
+     * @param end End of the buffer.
+     * @param valueBegin Begin of the field's fixed-size or length-delimited bytes.
+     * @return true if a complete field could be read.
+     */
+    bool nextField(const char *&cursor, const char *end, const char *&valueBegin) noexcept;
+
+    /**
+     * This method prepares the value of the field described by m_protoType
+     * and m_value to be consumed by the visit methods.
+     *
+     * @param valueBegin Begin of the field's fixed-size or length-delimited bytes.
+     */
+    void loadValue(const char *valueBegin) noexcept;
 
     void readBytesFromStream(std::istream &in, std::size_t bytesToReadFromStream, char *buffer) noexcept;
 
@@ -7063,9 +7393,124 @@ class LIBCLUON_API FromProtoVisitor {
     // Buffer for strings.
     std::vector<char> m_stringValue;
 
+    // Begin of the currently decoded length-delimited field, either pointing
+    // into m_stringValue or directly into a caller-supplied buffer.
+    const char *m_lengthDelimitedData{nullptr};
+
     uint64_t m_keyFieldType{0};
     ProtoConstants m_protoType{ProtoConstants::VARINT};
     uint32_t m_fieldId{0};
+
+   private:
+    // Location of a not yet decoded field inside the buffer given to indexFrom.
+    struct FieldLocation {
+        uint32_t fieldId;
+        ProtoConstants protoType;
+        // Decoded VarInt value or length of a length-delimited field.
+        uint64_t value;
+        const char *valueBegin;
+    };
+    std::vector<FieldLocation> m_fieldIndex{};
+};
+
+/**
+This class decodes a message of type T lazily from Proto format: the encoded
+bytes are indexed once and a field is decoded only when it is accessed for
+the first time. Wide messages with large byte fields, like ImageReading or
+PointCloudReading, are thus not decoded and copied completely when only a
+few fields are needed. An instance can be reused for consecutive messages.
+
+Example:
+\code{.cpp}
+cluon::LazyProtoDecoder<opendlv::proxy::ImageReading> decoder;
+if (decoder.decodeFrom(data, size)) {
+    // Only field 2 (width) is decoded; field 4 (data) is never copied.
+    const uint32_t width = decoder.field(2).width();
+}
+\endcode
+*/
+template <typename T>
+class LazyProtoDecoder {
+   private:
+    LazyProtoDecoder(const LazyProtoDecoder &) = delete;
+    LazyProtoDecoder(LazyProtoDecoder &&)      = delete;
+    LazyProtoDecoder &operator=(const LazyProtoDecoder &) = delete;
+    LazyProtoDecoder &operator=(LazyProtoDecoder &&) = delete;
+
+   public:
+    LazyProtoDecoder()  = default;
+    ~LazyProtoDecoder() = default;
+
+    /**
+     * This method indexes the given buffer, which must outlive the
+     * subsequent field accesses.
+     *
+     * @param data Pointer to the Proto-encoded bytes.
+     * @param size Number of bytes.
+     * @return true if the buffer could be indexed completely.
+     */
+    bool decodeFrom(const char *data, std::size_t size) noexcept {
+        m_ownedData.clear();
+        return reindex(data, size);
+    }
+
+    /**
+     * This method takes over the given buffer and indexes it.
+     *
+     * @param data Proto-encoded bytes.
+     * @return true if the buffer could be indexed completely.
+     */
+    bool decodeFrom(std::string &&data) noexcept {
+        m_ownedData = std::move(data);
+        return reindex(m_ownedData.data(), m_ownedData.size());
+    }
+
+    /**
+     * @param fieldId Field identifier to look up.
+     * @return true if the indexed buffer contains the given field.
+     */
+    bool hasField(uint32_t fieldId) const noexcept {
+        return m_decoder.hasField(fieldId);
+    }
+
+    /**
+     * This method decodes the given field unless it was already decoded.
+     *
+     * @param fieldId Field identifier to decode.
+     * @return Message with the given field decoded.
+     */
+    T &field(uint32_t fieldId) noexcept {
+        if (m_decodedFields.end() == std::find(m_decodedFields.begin(), m_decodedFields.end(), fieldId)) {
+            m_decoder.decodeField(fieldId, m_message);
+            m_decodedFields.push_back(fieldId);
+        }
+        return m_message;
+    }
+
+    /**
+     * This method decodes all fields that were not accessed so far.
+     *
+     * @return Completely decoded message.
+     */
+    T &message() noexcept {
+        for (uint32_t fieldId : m_decoder.indexedFields()) {
+            field(fieldId);
+        }
+        return m_message;
+    }
+
+   private:
+    bool reindex(const char *data, std::size_t size) noexcept {
+        m_message = T{};
+        m_decodedFields.clear();
+        return m_decoder.indexFrom(data, size);
+    }
+
+   private:
+    std::string m_ownedData{};
+    cluon::FromProtoVisitor m_decoder{};
+    T m_message{};
+    std::vector<uint32_t> m_decodedFields{};
 };
 } // namespace cluon
 
@@ -8021,6 +8466,43 @@ class LIBCLUON_API ToMsgPackVisitor {
 
 namespace cluon {
 
+/**
+ * This method writes the OD4 header for an Envelope of the given length into
+ * the five bytes at the given position.
+ *
+ * @param out Buffer holding the reserved header bytes.
+ * @param position Position of the first header byte.
+ * @param length Length of the Proto-encoded Envelope.
+ */
+inline void patchOD4Header(std::string &out, std::size_t position, std::size_t length) noexcept {
+    // Add OD4 header: 0x0D 0xA4 LEN0 LEN1 LEN2.
+    constexpr unsigned char OD4_HEADER_BYTE0 = 0x0D;
+    constexpr unsigned char OD4_HEADER_BYTE1 = 0xA4;
+    out[position + 0] = static_cast<char>(OD4_HEADER_BYTE0);
+    out[position + 1] = static_cast<char>(OD4_HEADER_BYTE1);
+    out[position + 2] = static_cast<char>(length & 0xFF);
+    out[position + 3] = static_cast<char>((length >> 8) & 0xFF);
+    out[position + 4] = static_cast<char>((length >> 16) & 0xFF);
+}
+
+/**
+ * This method transforms a given Envelope to a string representation to be
+ * sent to an OpenDaVINCI session and appends it to the given buffer.
+ *
+ * @param envelope Envelope with payload to be sent.
+ * @param out Buffer to append the representation to; its capacity is reused.
+ */
+inline void serializeEnvelope(cluon::data::Envelope &&envelope, std::string &out) noexcept {
+    constexpr std::size_t OD4_HEADER_SIZE{5};
+    const std::size_t HEADER_POSITION{out.size()};
+    out.append(OD4_HEADER_SIZE, '\0');
+    {
+        cluon::ToProtoVisitor protoEncoder{out};
+        envelope.accept(protoEncoder);
+    }
+    patchOD4Header(out, HEADER_POSITION, out.size() - HEADER_POSITION - OD4_HEADER_SIZE);
+}
+
 /**
  * This method transforms a given Envelope to a string representation to be
  * sent to an OpenDaVINCI session.
@@ -8030,34 +8512,37 @@ namespace cluon {
  */
 inline std::string serializeEnvelope(cluon::data::Envelope &&envelope) noexcept {
     std::string dataToSend;
-    {
-        std::stringstream sstr;
-
-        cluon::ToProtoVisitor protoEncoder;
-        envelope.accept(protoEncoder);
-
-        const std::string tmp{protoEncoder.encodedData()};
-        uint32_t length{static_cast<uint32_t>(tmp.size())};
-        length <<= 8;
-        length = htole32(length);
-
-        // Add OD4 header.
-        constexpr unsigned char OD4_HEADER_BYTE0 = 0x0D;
-        constexpr unsigned char OD4_HEADER_BYTE1 = 0xA4;
-        sstr.put(static_cast<char>(OD4_HEADER_BYTE0));
-        auto posByte1 = sstr.tellp();
-        sstr.write(reinterpret_cast<char *>(&length), static_cast<std::streamsize>(sizeof(uint32_t)));
-        auto posByte5 = sstr.tellp();
-        sstr.seekp(posByte1);
-        sstr.put(static_cast<char>(OD4_HEADER_BYTE1));
-        sstr.seekp(posByte5);
-
-        // Write payload.
-        sstr.write(tmp.data(), static_cast<std::streamsize>(tmp.size()));
+    serializeEnvelope(std::move(envelope), dataToSend);
+    return dataToSend;
+}
 
-        dataToSend = sstr.str();
+/**
+ * This method transforms a given Envelope together with the message to be
+ * carried as its payload to a string representation to be sent to an
+ * OpenDaVINCI session. The message is encoded in place as field 2 of the
+ * Envelope, which avoids encoding it into an intermediate string first; the
+ * Envelope's own serializedData is ignored.
+ *
+ * @param envelope Envelope with meta data for the message to be sent.
+ * @param message Message to be carried as payload.
+ * @param out Buffer to append the representation to; its capacity is reused.
+ */
+template <typename T>
+inline void serializeEnvelope(cluon::data::Envelope &envelope, T &message, std::string &out) noexcept {
+    constexpr std::size_t OD4_HEADER_SIZE{5};
+    const std::size_t HEADER_POSITION{out.size()};
+    out.append(OD4_HEADER_SIZE, '\0');
+    {
+        // Encode the fields in the same order as Envelope::accept does.
+        cluon::ToProtoVisitor protoEncoder{out};
+        envelope.accept(1, protoEncoder);
+        uint32_t payloadFieldId{2};
+        protoEncoder.visit(payloadFieldId, "std::string", "serializedData", message);
+        for (uint32_t fieldId{3}; fieldId <= 6; fieldId++) {
+            envelope.accept(fieldId, protoEncoder);
+        }
     }
-    return dataToSend;
+    patchOD4Header(out, HEADER_POSITION, out.size() - HEADER_POSITION - OD4_HEADER_SIZE);
 }
 
 /**
@@ -8119,17 +8604,123 @@ inline std::pair<bool, cluon::data::Envelope> extractEnvelope(std::istream &in)
 }
 
 /**
- * @return Extract a given Envelope's payload into the desired type.
+ * This method extracts an Envelope in place from the given buffer that holds
+ * bytes in format:
+ *
+ *    0x0D 0xA4 LEN0 LEN1 LEN2 Proto-encoded cluon::data::Envelope
+ *
+ * In contrast to the istream-based variant, no intermediate stream or copy
+ * of the buffer is created.
+ *
+ * @param data Pointer to the received bytes.
+ * @param size Number of received bytes.
+ * @param envelope Envelope to receive the decoded fields.
+ * @return true if a complete Envelope could be decoded.
  */
+inline bool extractEnvelope(const char *data, std::size_t size, cluon::data::Envelope &envelope) noexcept {
+    bool retVal{false};
+    constexpr std::size_t OD4_HEADER_SIZE{5};
+    if ((nullptr != data) && (OD4_HEADER_SIZE <= size) && (0x0D == static_cast<uint8_t>(data[0])) && (0xA4 == static_cast<uint8_t>(data[1]))) {
+        uint32_t length{0};
+        std::memcpy(&length, &data[1], sizeof(uint32_t));
+        const uint32_t LENGTH{le32toh(length) >> 8};
+        if (LENGTH <= (size - OD4_HEADER_SIZE)) {
+            cluon::FromProtoVisitor protoDecoder;
+            retVal = protoDecoder.decodeFrom(&data[OD4_HEADER_SIZE], LENGTH, envelope);
+        }
+    }
+    return retVal;
+}
+
+/**
+This class is visiting the field serializedData of an Envelope to decode the
+contained payload in place into a given message; the accessor
+Envelope::serializedData() would return a copy of the payload instead.
+*/
 template <typename T>
-inline T extractMessage(cluon::data::Envelope &&envelope) noexcept {
-    cluon::FromProtoVisitor decoder;
+class PayloadExtractor {
+   private:
+    PayloadExtractor(const PayloadExtractor &) = delete;
+    PayloadExtractor(PayloadExtractor &&)      = delete;
+    PayloadExtractor &operator=(const PayloadExtractor &) = delete;
+    PayloadExtractor &operator=(PayloadExtractor &&) = delete;
+
+   public:
+    explicit PayloadExtractor(T &msg) noexcept
+        : m_msg(msg) {}
+
+    void visit(uint32_t /*id*/, std::string && /*typeName*/, std::string && /*name*/, std::string &v) noexcept {
+        cluon::FromProtoVisitor decoder;
+        decoder.decodeFrom(v.data(), v.size(), m_msg);
+    }
+
+    template <typename U>
+    void visit(uint32_t /*id*/, std::string && /*typeName*/, std::string && /*name*/, U & /*v*/) noexcept {}
+
+   private:
+    T &m_msg;
+};
+
+/**
+This class is visiting the field serializedData of an Envelope to hand the
+contained payload over to a LazyProtoDecoder without copying it.
+*/
+template <typename T>
+class LazyPayloadExtractor {
+   private:
+    LazyPayloadExtractor(const LazyPayloadExtractor &) = delete;
+    LazyPayloadExtractor(LazyPayloadExtractor &&)      = delete;
+    LazyPayloadExtractor &operator=(const LazyPayloadExtractor &) = delete;
+    LazyPayloadExtractor &operator=(LazyPayloadExtractor &&) = delete;
+
+   public:
+    explicit LazyPayloadExtractor(cluon::LazyProtoDecoder<T> &decoder) noexcept
+        : m_decoder(decoder) {}
+
+    void visit(uint32_t /*id*/, std::string && /*typeName*/, std::string && /*name*/, std::string &v) noexcept {
+        m_indexed = m_decoder.decodeFrom(std::move(v));
+    }
 
-    std::stringstream sstr(envelope.serializedData());
-    decoder.decodeFrom(sstr);
+    template <typename U>
+    void visit(uint32_t /*id*/, std::string && /*typeName*/, std::string && /*name*/, U & /*v*/) noexcept {}
 
+    bool indexed() const noexcept {
+        return m_indexed;
+    }
+
+   private:
+    cluon::LazyProtoDecoder<T> &m_decoder;
+    bool m_indexed{false};
+};
+
+/**
+ * This method hands a given Envelope's payload over to a lazy decoder;
+ * fields are decoded only when accessed through the decoder.
+ *
+ * @param envelope Envelope to extract the payload from.
+ * @param decoder Lazy decoder to take over the payload.
+ * @return true if the payload could be indexed.
+ */
+template <typename T>
+inline bool extractMessage(cluon::data::Envelope &&envelope, cluon::LazyProtoDecoder<T> &decoder) noexcept {
+    // Field 2 of Envelope is serializedData.
+    constexpr uint32_t SERIALIZED_DATA_FIELD_ID{2};
+    cluon::LazyPayloadExtractor<T> extractor{decoder};
+    envelope.accept(SERIALIZED_DATA_FIELD_ID, extractor);
+    return extractor.indexed();
+}
+
+/**
+ * @return Extract a given Envelope's payload into the desired type.
+ */
+template <typename T>
+inline T extractMessage(cluon::data::Envelope &&envelope) noexcept {
     T msg;
-    msg.accept(decoder);
+
+    // Field 2 of Envelope is serializedData.
+    constexpr uint32_t SERIALIZED_DATA_FIELD_ID{2};
+    cluon::PayloadExtractor<T> extractor{msg};
+    envelope.accept(SERIALIZED_DATA_FIELD_ID, extractor);
 
     return msg;
 }
@@ -8863,14 +9454,18 @@ class LIBCLUON_API LCMToGenericMessage {
 //#include "cluon/cluon.hpp"
 //#include "cluon/cluonDataStructures.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace cluon {
 /**
@@ -8938,6 +9533,7 @@ class LIBCLUON_API OD4Session {
      *        to have both: a delegate for "catch-all" and the data-triggered ones.
      */
     OD4Session(uint16_t CID, std::function<void(cluon::data::Envelope &&envelope)> delegate = nullptr) noexcept;
+    ~OD4Session() noexcept;
 
     /**
      * This method will send a given Envelope to this OpenDaVINCI v4 session.
@@ -8946,6 +9542,24 @@ class LIBCLUON_API OD4Session {
      */
     void send(cluon::data::Envelope &&envelope) noexcept;
 
+    /**
+     * This method enables the batching of outgoing Envelopes: Envelopes are
+     * collected until maxEnvelopes are pending or until the oldest pending
+     * Envelope has waited for the given window; then, they are sent together
+     * using as few system calls as possible (sendmmsg on Linux). Batching is
+     * disabled by default and when maxEnvelopes is smaller than 2.
+     *
+     * @param maxEnvelopes Number of pending Envelopes that triggers sending.
+     * @param window Maximum time an Envelope is held back.
+     */
+    void batchSending(uint32_t maxEnvelopes, std::chrono::microseconds window) noexcept;
+
+    /**
+     * This method sends all pending Envelopes immediately; it is meant to be
+     * called after sending latency-critical messages when batching is enabled.
+     */
+    void flush() noexcept;
+
     /**
      * This method sets a delegate to be called data-triggered on arrival
      * of a new Envelope for a given message identifier.
@@ -8979,19 +9593,19 @@ class LIBCLUON_API OD4Session {
     void send(T &message, const cluon::data::TimeStamp &sampleTimeStamp = cluon::data::TimeStamp(), uint32_t senderStamp = 0) noexcept {
         try {
             std::lock_guard<std::mutex> lck(m_senderMutex);
-            cluon::ToProtoVisitor protoEncoder;
 
             cluon::data::Envelope envelope;
             {
                 envelope.dataType(static_cast<int32_t>(message.ID()));
-                message.accept(protoEncoder);
-                envelope.serializedData(protoEncoder.encodedData());
                 envelope.sent(cluon::time::now());
                 envelope.sampleTimeStamp((0 == (sampleTimeStamp.seconds() + sampleTimeStamp.microseconds())) ? envelope.sent() : sampleTimeStamp);
                 envelope.senderStamp(senderStamp);
             }
 
-            send(std::move(envelope));
+            // Encode message and Envelope in one pass into a single buffer.
+            std::string dataToSend;
+            cluon::serializeEnvelope(envelope, message, dataToSend);
+            sendInternal(std::move(dataToSend));
         } catch (...) {} // LCOV_EXCL_LINE
     }
 
@@ -9001,6 +9615,8 @@ class LIBCLUON_API OD4Session {
    private:
     void callback(std::string &&data, std::string &&from, std::chrono::system_clock::time_point &&timepoint) noexcept;
     void sendInternal(std::string &&dataToSend) noexcept;
+    void sendPendingBatch() noexcept;
+    void sendBatchesWhenDue() noexcept;
 
    private:
     std::unique_ptr<cluon::UDPReceiver> m_receiver;
@@ -9008,6 +9624,16 @@ class LIBCLUON_API OD4Session {
 
     std::mutex m_senderMutex{};
 
+    // Pending serialized Envelopes when batching is enabled; guarded by m_batchMutex.
+    std::mutex m_batchMutex{};
+    std::condition_variable m_batchCondition{};
+    std::vector<std::string> m_batch{};
+    uint32_t m_batchMaxEnvelopes{0};
+    std::chrono::microseconds m_batchWindow{0};
+    std::chrono::steady_clock::time_point m_batchDeadline{};
+    std::atomic<bool> m_batchThreadRunning{false};
+    std::thread m_batchThread{};
+
     std::function<void(cluon::data::Envelope &&envelope)> m_delegate{nullptr};
 
     std::mutex m_mapOfDataTriggeredDelegatesMutex{};
@@ -9030,28 +9656,143 @@ class LIBCLUON_API OD4Session {
 //#include "cluon/cluon.hpp"
 //#include "cluon/cluonDataStructures.hpp"
 
-#include <cstdint>
-#include <deque>
-#include <fstream>
-#include <functional>
-#include <map>
-#include <memory>
-#include <mutex>
-#include <string>
-#include <thread>
-#include <utility>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace cluon {
+
+class LIBCLUON_API IndexEntry {
+   public:
+    IndexEntry() = default;
+    IndexEntry(const int64_t &sampleTimeStamp, const uint64_t &filePosition) noexcept;
+    IndexEntry(const int64_t &sampleTimeStamp, const uint64_t &filePosition, const int32_t &dataType, const uint32_t &size) noexcept;
+
+   public:
+    int64_t m_sampleTimeStamp{0};
+    uint64_t m_filePosition{0};
+    int32_t m_dataType{0};
+    uint32_t m_size{0};
+    bool m_available{0};
+};
+
+/**
+This class provides access to the persistent index of a .rec file that is
+stored next to it as <file>.idx. The index is memory-mapped when opened and
+entries are read on demand; hence, opening is independent of the length of
+the recording. An index is only used if the size and modification time of
+the .rec file still match the values stored in the index.
+
+Format (all values in little Endian):
+
+    Header:  "CLUONIDX" | uint32 version | uint32 entry size |
+             uint64 .rec file size | int64 .rec file mtime in ns |
+             uint64 number of entries
+    Entries: int64 sampleTimeStamp in us | uint64 file position |
+             int32 dataType | uint32 size incl. OD4 header,
+             sorted by sampleTimeStamp and file position
+*/
+class LIBCLUON_API RecIndex {
+   public:
+    enum : uint32_t {
+        VERSION     = 1,
+        HEADER_SIZE = 8 + 4 + 4 + 8 + 8 + 8,
+        ENTRY_SIZE  = 8 + 8 + 4 + 4,
+    };
+
+   private:
+    RecIndex(const RecIndex &) = delete;
+    RecIndex(RecIndex &&)      = delete;
+    RecIndex &operator=(const RecIndex &) = delete;
+    RecIndex &operator=(RecIndex &&) = delete;
+
+   public:
+    /**
+     * Constructor to open the index belonging to the given .rec file.
+     *
+     * @param recFile .rec file to open the index for.
+     */
+    explicit RecIndex(const std::string &recFile) noexcept;
+    ~RecIndex() noexcept;
+
+    /**
+     * @return true if an up-to-date index was found and mapped.
+     */
+    bool valid() const noexcept;
+
+    /**
+     * @return Number of entries in the index.
+     */
+    uint64_t size() const noexcept;
+
+    /**
+     * @param i Position of the entry to return; must be smaller than size().
+     * @return Entry at the given position.
+     */
+    IndexEntry at(uint64_t i) const noexcept;
+
+    /**
+     * @param recFile .rec file.
+     * @return Name of the index file belonging to the given .rec file.
+     */
+    static std::string indexFileFor(const std::string &recFile) noexcept;
+
+    /**
+     * This method writes an index for the given .rec file. The index is
+     * written to a temporary file first that is renamed when complete.
+     *
+     * @param recFile .rec file to write the index for.
+     * @param entries Entries sorted by sample time stamp.
+     * @return true if the index was written successfully.
+     */
+    static bool write(const std::string &recFile, const std::vector<IndexEntry> &entries) noexcept;
+
+   private:
+    /**
+     * @param recFile .rec file.
+     * @param size Size of the given file.
+     * @param modificationTime Modification time of the given file in nanoseconds.
+     * @return true if the file's status could be determined.
+     */
+    static bool statusOf(const std::string &recFile, uint64_t &size, int64_t &modificationTime) noexcept;
 
-namespace cluon {
+   private:
+    const char *m_mappedFile{nullptr};
+    std::size_t m_mappedFileSize{0};
+    uint64_t m_numberOfEntries{0};
+};
 
-class LIBCLUON_API IndexEntry {
+/**
+This class is a view onto an Envelope inside a memory-mapped .rec file as
+handed out by Player; it is valid as long as the Player exists.
+*/
+class LIBCLUON_API EnvelopeView {
    public:
-    IndexEntry() = default;
-    IndexEntry(const int64_t &sampleTimeStamp, const uint64_t &filePosition) noexcept;
+    EnvelopeView() = default;
+    EnvelopeView(const char *data, std::size_t size, int64_t sampleTimeStamp) noexcept;
+
+    /**
+     * This method decodes the viewed bytes into an Envelope.
+     *
+     * @param envelope Envelope to receive the decoded fields.
+     * @return true if the Envelope could be decoded.
+     */
+    bool decode(cluon::data::Envelope &envelope) const noexcept;
 
    public:
+    // Bytes in format 0x0D 0xA4 LEN0 LEN1 LEN2 Proto-encoded cluon::data::Envelope;
+    // they can be sent as is to an OpenDaVINCI session.
+    const char *m_data{nullptr};
+    std::size_t m_size{0};
     int64_t m_sampleTimeStamp{0};
-    uint64_t m_filePosition{0};
-    bool m_available{0};
 };
 
 class LIBCLUON_API Player {
@@ -9062,6 +9803,8 @@ class LIBCLUON_API Player {
         MAX_DELAY_IN_MICROSECONDS       = 1 * ONE_SECOND_IN_MICROSECONDS,
         LOOK_AHEAD_IN_S                 = 30,
         MIN_ENTRIES_FOR_LOOK_AHEAD      = 5000,
+        CACHE_CAPACITY_FACTOR           = 2,
+        OD4_HEADER_SIZE                 = 5,
     };
 
    private:
@@ -9077,8 +9820,12 @@ class LIBCLUON_API Player {
      * @param file File to play.
      * @param autoRewind True if the file should be rewind at EOF.
      * @param threading If set to true, player will load new envelopes from the files in background.
+     * @param memoryMapped If set to true, player will map the file into memory and parse envelopes
+     *        in place instead of reading them through a stream into a cache; threading is
+     *        not needed in this mode as the kernel reads ahead. Falls back to the stream if
+     *        the file cannot be mapped.
      */
-    Player(const std::string &file, const bool &autoRewind, const bool &threading) noexcept;
+    Player(const std::string &file, const bool &autoRewind, const bool &threading, const bool &memoryMapped = false) noexcept;
     ~Player();
 
     /**
@@ -9087,6 +9834,20 @@ class LIBCLUON_API Player {
      */
     std::pair<bool, cluon::data::Envelope> getNextEnvelopeToBeReplayed() noexcept;
 
+    /**
+     * This method is only available for memory-mapped files and does neither
+     * decode nor copy the next Envelope to be replayed.
+     *
+     * @return Pair of bool and view onto the next cluon::data::Envelope to be replayed;
+     *         if bool is false, no next Envelope is available.
+     */
+    std::pair<bool, cluon::EnvelopeView> getNextEnvelopeViewToBeReplayed() noexcept;
+
+    /**
+     * @return true if the .rec file is memory-mapped.
+     */
+    bool isMemoryMapped() const noexcept;
+
     /**
      * @return real delay in microseconds to be waited before the next cluon::data::Envelope should be delivered.
      */
@@ -9102,8 +9863,22 @@ class LIBCLUON_API Player {
      */
     void rewind() noexcept;
 
+    /**
+     * This method moves the replay position to the given ratio of all
+     * entries in the .rec file.
+     *
+     * @param ratio Position in [0, 1].
+     */
     void seekTo(float ratio) noexcept;
 
+    /**
+     * This method moves the replay position to the first entry with a
+     * sample time stamp not before the given one using binary search.
+     *
+     * @param sampleTimeStamp Sample time stamp to seek to.
+     */
+    void seekTo(const cluon::data::TimeStamp &sampleTimeStamp) noexcept;
+
     /**
      * @return total amount of cluon::data::Envelopes in the .rec file.
      */
@@ -9132,10 +9907,25 @@ class LIBCLUON_API Player {
     void resetCaches() noexcept;
 
     /**
-     * This method resets the iterators.
+     * This method resets the positions in the global index.
      */
     inline void resetIterators() noexcept;
 
+    /**
+     * This method moves the replay position to the given entry of the
+     * global index and refills the cache from there.
+     *
+     * @param entry Position in the global index to continue the replay from.
+     */
+    void seekToEntry(std::size_t entry) noexcept;
+
+    /**
+     * This method must be called with m_indexMutex held.
+     *
+     * @return Number of entries read from the .rec file but not yet replayed.
+     */
+    uint32_t numberOfCachedEntries() const noexcept;
+
     /**
      * This method fills the cache by trying to read up
      * to maxNumberOfEntriesToReadFromFile from the rec file.
@@ -9145,6 +9935,48 @@ class LIBCLUON_API Player {
      */
     uint32_t fillEnvelopeCache(const uint32_t &maxNumberOfEntriesToReadFromFile) noexcept;
 
+    /**
+     * This method maps the .rec file into memory.
+     *
+     * @return true if the file could be mapped.
+     */
+    bool mapRecFile() noexcept;
+
+    /**
+     * This method initializes the global index from the persistent index
+     * next to the .rec file.
+     *
+     * @return true if an up-to-date persistent index was found.
+     */
+    bool initializeIndexFromRecIndex() noexcept;
+
+    /**
+     * This method initializes the global index by reading all envelopes
+     * from the .rec file using the stream.
+     */
+    void initializeIndexFromRecFile() noexcept;
+
+    /**
+     * This method initializes the global index by parsing all envelopes in
+     * place from the memory-mapped .rec file.
+     */
+    void initializeIndexFromMappedFile() noexcept;
+
+    /**
+     * This method advises the kernel to read ahead the mapped pages of up
+     * to maxNumberOfEntriesToPrefetch next entries to be replayed.
+     *
+     * @param maxNumberOfEntriesToPrefetch Maximum number of entries to prefetch.
+     * @return Number of entries prefetched.
+     */
+    uint32_t prefetchMappedEntries(const uint32_t &maxNumberOfEntriesToPrefetch) noexcept;
+
+    /**
+     * @param filePosition Position of an Envelope in the mapped file.
+     * @return View onto the Envelope at the given position.
+     */
+    cluon::EnvelopeView viewAt(const uint64_t &filePosition) const noexcept;
+
     /**
      * This method checks the availability of the next cluon::data::Envelope
      * to be replayed from the cache.
@@ -9160,22 +9992,27 @@ class LIBCLUON_API Player {
     std::fstream m_recFile;
     bool m_recFileValid;
 
+    // Memory-mapped .rec file.
+    bool m_memoryMapped;
+    const char *m_mappedFile{nullptr};
+    std::size_t m_mappedFileSize{0};
+
    private: // Player states.
     bool m_autoRewind;
 
    private: // Index and cache management.
-    // Global index: Mapping SampleTimeStamp --> cache entry (holding the actual content from .rec file).
+    // Global index: Entries sorted chronologically by SampleTimeStamp and
+    // pointing to the actual content in the .rec file.
     mutable std::mutex m_indexMutex;
-    std::multimap<int64_t, IndexEntry> m_index;
+    std::vector<IndexEntry> m_index;
 
-    // Pointers to the current envelope to be replayed and the
-    // envelope that has be replayed from the global index.
-    std::multimap<int64_t, IndexEntry>::iterator m_previousPreviousEnvelopeAlreadyReplayed;
-    std::multimap<int64_t, IndexEntry>::iterator m_previousEnvelopeAlreadyReplayed;
-    std::multimap<int64_t, IndexEntry>::iterator m_currentEnvelopeToReplay;
+    // Positions in the global index of the envelope that has been replayed
+    // last and of the current envelope to be replayed; m_index.size() marks the end.
+    std::size_t m_previousEnvelopeAlreadyReplayed;
+    std::size_t m_currentEnvelopeToReplay;
 
-    // Information about the index.
-    std::multimap<int64_t, IndexEntry>::iterator m_nextEntryToReadFromRecFile;
+    // Position in the global index of the next envelope to be read from the .rec file.
+    std::size_t m_nextEntryToReadFromRecFile;
 
     uint32_t m_desiredInitialLevel;
 
@@ -9213,8 +10050,10 @@ class LIBCLUON_API Player {
     bool m_envelopeCacheFillingThreadIsRunning;
     std::thread m_envelopeCacheFillingThread;
 
-    // Mapping of pos_type (within .rec file) --> cluon::data::Envelope (read from .rec file).
-    std::map<uint64_t, cluon::data::Envelope> m_envelopeCache;
+    // Ring buffer holding the envelopes read from the .rec file for the
+    // positions [m_currentEnvelopeToReplay, m_nextEntryToReadFromRecFile)
+    // in the global index; position i is stored at i % m_envelopeCache.size().
+    std::vector<cluon::data::Envelope> m_envelopeCache;
 
    public:
     void setPlayerListener(std::function<void(cluon::data::PlayerStatus playerStatus)> playerListener) noexcept;
@@ -10040,6 +10879,7 @@ inline std::string getIPv4FromHostname(const std::string &hostname) noexcept {
     #include <arpa/inet.h>
     #include <sys/socket.h>
     #include <sys/types.h>
+    #include <sys/uio.h>
     #include <unistd.h>
 #endif
 // clang-format on
@@ -10047,6 +10887,7 @@ inline std::string getIPv4FromHostname(const std::string &hostname) noexcept {
 #include <cerrno>
 #include <cstring>
 #include <algorithm>
+#include <array>
 #include <iterator>
 #include <sstream>
 #include <vector>
@@ -10150,6 +10991,87 @@ inline std::pair<ssize_t, int32_t> UDPSender::send(std::string &&data) const noe
 
     return {bytesSent, (0 > bytesSent ? errno : 0)};
 }
+
+inline std::pair<ssize_t, int32_t> UDPSender::sendBatch(std::vector<std::string> &&datagrams) const noexcept {
+    if (-1 == m_socket) {
+        return {-1, EBADF};
+    }
+
+    constexpr uint16_t MAX_LENGTH = static_cast<uint16_t>(UDPPacketSizeConstraints::MAX_SIZE_UDP_PACKET)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_IPv4_HEADER)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_UDP_HEADER);
+
+    ssize_t totalBytesSent{0};
+    int32_t errorCode{0};
+
+    std::lock_guard<std::mutex> lck(m_socketMutex);
+#ifdef __linux__
+    constexpr std::size_t BATCH_SIZE{64};
+    std::array<struct iovec, BATCH_SIZE> iovecs{};
+    std::array<struct mmsghdr, BATCH_SIZE> messages{};
+
+    auto it = datagrams.begin();
+    while (it != datagrams.end()) {
+        // Collect the next batch of sendable datagrams.
+        unsigned int entries{0};
+        for (; (it != datagrams.end()) && (entries < BATCH_SIZE); it++) {
+            if (it->empty()) {
+                continue;
+            }
+            if (MAX_LENGTH < it->size()) {
+                errorCode = E2BIG;
+                continue;
+            }
+            iovecs[entries].iov_base                  = const_cast<char *>(it->data()); // NOLINT
+            iovecs[entries].iov_len                   = it->size();
+            messages[entries].msg_hdr                 = {};
+            messages[entries].msg_hdr.msg_name        = const_cast<struct sockaddr_in *>(&m_sendToAddress); // NOLINT
+            messages[entries].msg_hdr.msg_namelen     = sizeof(m_sendToAddress);
+            messages[entries].msg_hdr.msg_iov         = &iovecs[entries];
+            messages[entries].msg_hdr.msg_iovlen      = 1;
+            messages[entries].msg_len                 = 0;
+            entries++;
+        }
+
+        // sendmmsg might send fewer datagrams than requested.
+        unsigned int sent{0};
+        while (sent < entries) {
+            const int retVal{::sendmmsg(m_socket, &messages[sent], entries - sent, 0)};
+            if (0 > retVal) {
+                errorCode = errno;
+                // Skip the failing datagram.
+                sent++;
+            } else {
+                for (int i{0}; i < retVal; i++) { totalBytesSent += static_cast<ssize_t>(messages[sent + static_cast<unsigned int>(i)].msg_len); }
+                sent += static_cast<unsigned int>(retVal);
+            }
+        }
+    }
+#else
+    for (auto &data : datagrams) {
+        if (data.empty()) {
+            continue;
+        }
+        if (MAX_LENGTH < data.size()) {
+            errorCode = E2BIG;
+            continue;
+        }
+        ssize_t bytesSent = ::sendto(m_socket,
+                                     data.c_str(),
+                                     data.length(),
+                                     0,
+                                     reinterpret_cast<const struct sockaddr *>(&m_sendToAddress), // NOLINT
+                                     sizeof(m_sendToAddress));
+        if (0 > bytesSent) {
+            errorCode = errno;
+        } else {
+            totalBytesSent += bytesSent;
+        }
+    }
+#endif
+
+    return {totalBytesSent, errorCode};
+}
 } // namespace cluon
 /*
  * Copyright (C) 2017-2018  Christian Berger
@@ -10177,6 +11099,8 @@ inline std::pair<ssize_t, int32_t> UDPSender::send(std::string &&data) const noe
 #else
     #ifdef __linux__
         #include <linux/sockios.h>
+        #include <sys/epoll.h>
+        #include <sys/eventfd.h>
     #endif
 
     #include <arpa/inet.h>
@@ -10349,6 +11273,37 @@ inline UDPReceiver::UDPReceiver(const std::string &receiveFromAddress,
             }
         }
 
+#ifdef __linux__
+        if (!(m_socket < 0)) {
+            // Let the kernel attach the receive time stamp to every datagram.
+            int32_t YES = 1;
+            auto retVal = ::setsockopt(m_socket, SOL_SOCKET, SO_TIMESTAMPNS, &YES, sizeof(YES));
+            if (0 > retVal) {
+                std::cerr << "[cluon::UDPReceiver] Error while trying to set SO_TIMESTAMPNS: " << errno << std::endl; // LCOV_EXCL_LINE
+            }
+        }
+
+        if (!(m_socket < 0)) {
+            // Wait for new data or for the wake-up event on shutdown without polling.
+            m_epollFD  = ::epoll_create1(EPOLL_CLOEXEC);
+            m_wakeupFD = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+            if ((0 > m_epollFD) || (0 > m_wakeupFD)) {
+                closeSocket(errno); // LCOV_EXCL_LINE
+            } else {
+                struct epoll_event socketEvent {};
+                socketEvent.events  = EPOLLIN;
+                socketEvent.data.fd = m_socket;
+                struct epoll_event wakeupEvent {};
+                wakeupEvent.events  = EPOLLIN;
+                wakeupEvent.data.fd = m_wakeupFD;
+                if ((0 > ::epoll_ctl(m_epollFD, EPOLL_CTL_ADD, m_socket, &socketEvent))
+                    || (0 > ::epoll_ctl(m_epollFD, EPOLL_CTL_ADD, m_wakeupFD, &wakeupEvent))) {
+                    closeSocket(errno); // LCOV_EXCL_LINE
+                }
+            }
+        }
+#endif
+
         // Fill list of local IP address to avoid sending data to ourselves.
         if (!(m_socket < 0)) {
 #ifdef WIN32
@@ -10398,8 +11353,14 @@ inline UDPReceiver::UDPReceiver(const std::string &receiveFromAddress,
             } catch (...) { closeSocket(ECHILD); } // LCOV_EXCL_LINE
 
             try {
+                // UDP is lossy anyway: rather drop stale datagrams than stall the receiving thread.
+                constexpr std::size_t PIPELINE_CAPACITY{4096};
                 m_pipeline = std::make_shared<cluon::NotifyingPipeline<PipelineEntry>>(
-                    [this](PipelineEntry &&entry) { this->m_delegate(std::move(entry.m_data), std::move(entry.m_from), std::move(entry.m_sampleTime)); });
+                    [this](PipelineEntry &&entry) {
+                        this->m_delegate(std::move(entry.m_data), std::string(this->formatSender(entry.m_from)), std::move(entry.m_sampleTime));
+                    },
+                    PIPELINE_CAPACITY,
+                    PipelineBackpressure::DROP_OLDEST);
                 if (m_pipeline) {
                     // Let the operating system spawn the thread.
                     using namespace std::literals::chrono_literals; // NOLINT
@@ -10414,6 +11375,15 @@ inline UDPReceiver::~UDPReceiver() noexcept {
     {
         m_readFromSocketThreadRunning.store(false);
 
+#ifdef __linux__
+        // Wake up the receiving thread blocked in epoll_wait.
+        if (!(m_wakeupFD < 0)) {
+            const uint64_t WAKEUP{1};
+            auto retVal = ::write(m_wakeupFD, &WAKEUP, sizeof(WAKEUP));
+            (void)retVal;
+        }
+#endif
+
         // Joining the thread could fail.
         try {
             if (m_readFromSocketThread.joinable()) {
@@ -10457,12 +11427,133 @@ inline void UDPReceiver::closeSocket(int errorCode) noexcept {
 #endif
     }
     m_socket = -1;
+
+#ifdef __linux__
+    if (!(m_epollFD < 0)) {
+        ::close(m_epollFD);
+    }
+    m_epollFD = -1;
+    if (!(m_wakeupFD < 0)) {
+        ::close(m_wakeupFD);
+    }
+    m_wakeupFD = -1;
+#endif
 }
 
 inline bool UDPReceiver::isRunning() const noexcept {
     return (m_readFromSocketThreadRunning.load() && !TerminateHandler::instance().isTerminated.load());
 }
 
+inline bool UDPReceiver::isSentFromUs(const struct sockaddr_in &remote) const noexcept {
+    // Check the port first as it is cheaper than looking up the address.
+    bool sentFromUs{m_localSendFromPort == ntohs(remote.sin_port)};
+    if (sentFromUs) {
+        const unsigned long RECVFROM_IP{remote.sin_addr.s_addr};
+        sentFromUs = (m_listOfLocalIPAddresses.end() != m_listOfLocalIPAddresses.find(RECVFROM_IP));
+    }
+    return sentFromUs;
+}
+
+inline const std::string &UDPReceiver::formatSender(const struct sockaddr_in &remote) noexcept {
+    if (m_lastFrom.empty() || (m_lastFromAddress.sin_addr.s_addr != remote.sin_addr.s_addr) || (m_lastFromAddress.sin_port != remote.sin_port)) {
+        std::array<char, INET_ADDRSTRLEN> remoteAddress{};
+        ::inet_ntop(AF_INET, &remote.sin_addr, remoteAddress.data(), remoteAddress.max_size());
+        m_lastFrom        = std::string(remoteAddress.data()) + ':' + std::to_string(ntohs(remote.sin_port));
+        m_lastFromAddress = remote;
+    }
+    return m_lastFrom;
+}
+
+#ifdef __linux__
+inline void UDPReceiver::readFromSocket() noexcept {
+    // Create buffers to receive a batch of datagrams with one system call.
+    constexpr uint16_t MAX_LENGTH = static_cast<uint16_t>(UDPPacketSizeConstraints::MAX_SIZE_UDP_PACKET)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_IPv4_HEADER)
+                                    - static_cast<uint16_t>(UDPPacketSizeConstraints::SIZE_UDP_HEADER);
+    constexpr unsigned int BATCH_SIZE{16};
+    constexpr std::size_t CONTROL_SIZE{CMSG_SPACE(sizeof(struct timespec))};
+
+    std::vector<char> buffers(BATCH_SIZE * MAX_LENGTH);
+    std::array<std::array<char, CONTROL_SIZE>, BATCH_SIZE> controls{};
+    std::array<struct sockaddr_in, BATCH_SIZE> remotes{};
+    std::array<struct iovec, BATCH_SIZE> iovecs{};
+    std::array<struct mmsghdr, BATCH_SIZE> messages{};
+
+    constexpr int MAX_EVENTS{2};
+    std::array<struct epoll_event, MAX_EVENTS> events{};
+
+    // Indicate to main thread that we are ready.
+    m_readFromSocketThreadRunning.store(true);
+
+    while (m_readFromSocketThreadRunning.load()) {
+        // Sleep until new data is available or we are woken up to stop.
+        const int NUMBER_OF_EVENTS{::epoll_wait(m_epollFD, events.data(), MAX_EVENTS, -1)};
+        if ((0 > NUMBER_OF_EVENTS) && (EINTR != errno)) {
+            break; // LCOV_EXCL_LINE
+        }
+
+        ssize_t totalBytesRead{0};
+        int receivedMessages{0};
+        do {
+            // recvmmsg overwrites the lengths; reinitialize the headers for every batch.
+            for (unsigned int i{0}; i < BATCH_SIZE; i++) {
+                iovecs[i].iov_base                  = &buffers[i * MAX_LENGTH];
+                iovecs[i].iov_len                   = MAX_LENGTH;
+                messages[i].msg_hdr.msg_name        = &remotes[i];
+                messages[i].msg_hdr.msg_namelen     = sizeof(struct sockaddr_in);
+                messages[i].msg_hdr.msg_iov         = &iovecs[i];
+                messages[i].msg_hdr.msg_iovlen      = 1;
+                messages[i].msg_hdr.msg_control     = controls[i].data();
+                messages[i].msg_hdr.msg_controllen  = CONTROL_SIZE;
+                messages[i].msg_hdr.msg_flags       = 0;
+                messages[i].msg_len                 = 0;
+            }
+
+            receivedMessages = ::recvmmsg(m_socket, messages.data(), BATCH_SIZE, MSG_DONTWAIT, nullptr);
+            for (int i{0}; (i < receivedMessages) && (nullptr != m_delegate); i++) {
+                const ssize_t bytesRead{static_cast<ssize_t>(messages[i].msg_len)};
+                if ((0 < bytesRead) && !isSentFromUs(remotes[i])) {
+                    // Use the kernel's receive time stamp if available.
+                    std::chrono::system_clock::time_point timestamp;
+                    bool hasTimeStamp{false};
+                    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&messages[i].msg_hdr); nullptr != cmsg; cmsg = CMSG_NXTHDR(&messages[i].msg_hdr, cmsg)) {
+                        if ((SOL_SOCKET == cmsg->cmsg_level) && (SCM_TIMESTAMPNS == cmsg->cmsg_type)) {
+                            struct timespec receivedTimeStamp {};
+                            std::memcpy(&receivedTimeStamp, CMSG_DATA(cmsg), sizeof(receivedTimeStamp));
+                            // Transform struct timespec to C++ chrono.
+                            std::chrono::time_point<std::chrono::system_clock, std::chrono::nanoseconds> transformedTimePoint(
+                                std::chrono::nanoseconds(receivedTimeStamp.tv_sec * 1000000000L + receivedTimeStamp.tv_nsec));
+                            timestamp    = std::chrono::time_point_cast<std::chrono::system_clock::duration>(transformedTimePoint);
+                            hasTimeStamp = true;
+                        }
+                    }
+                    if (!hasTimeStamp) {
+                        timestamp = std::chrono::system_clock::now(); // LCOV_EXCL_LINE
+                    }
+
+                    // Create a pipeline entry to be processed concurrently.
+                    PipelineEntry pe;
+                    pe.m_data       = std::string(&buffers[static_cast<std::size_t>(i) * MAX_LENGTH], static_cast<size_t>(bytesRead));
+                    pe.m_from       = remotes[i];
+                    pe.m_sampleTime = timestamp;
+
+                    // Store entry in queue.
+                    if (m_pipeline) {
+                        m_pipeline->add(std::move(pe));
+                    }
+                    totalBytesRead += bytesRead;
+                }
+            }
+        } while (static_cast<int>(BATCH_SIZE) == receivedMessages);
+
+        if (static_cast<int32_t>(totalBytesRead) > 0) {
+            if (m_pipeline) {
+                m_pipeline->notifyAll();
+            }
+        }
+    }
+}
+#else
 inline void UDPReceiver::readFromSocket() noexcept {
     // Create buffer to store data from socket.
     constexpr uint16_t MAX_LENGTH = static_cast<uint16_t>(UDPPacketSizeConstraints::MAX_SIZE_UDP_PACKET)
@@ -10475,10 +11566,6 @@ inline void UDPReceiver::readFromSocket() noexcept {
     // Define file descriptor set to watch for read operations.
     fd_set setOfFiledescriptorsToReadFrom{};
 
-    // Sender address and port.
-    constexpr uint16_t MAX_ADDR_SIZE{1024};
-    std::array<char, MAX_ADDR_SIZE> remoteAddress{};
-
     struct sockaddr_storage remote {};
     socklen_t addrLength{sizeof(remote)};
 
@@ -10508,43 +11595,14 @@ inline void UDPReceiver::readFromSocket() noexcept {
                                        reinterpret_cast<socklen_t *>(&addrLength));  // NOLINT
 
                 if ((0 < bytesRead) && (nullptr != m_delegate)) {
-#ifdef __linux__
-                    std::chrono::system_clock::time_point timestamp;
-                    struct timeval receivedTimeStamp {};
-                    if (0 == ::ioctl(m_socket, SIOCGSTAMP, &receivedTimeStamp)) { // NOLINT
-                        // Transform struct timeval to C++ chrono.
-                        std::chrono::time_point<std::chrono::system_clock, std::chrono::microseconds> transformedTimePoint(
-                            std::chrono::microseconds(receivedTimeStamp.tv_sec * 1000000L + receivedTimeStamp.tv_usec));
-                        timestamp = std::chrono::time_point_cast<std::chrono::system_clock::duration>(transformedTimePoint);
-                    } else { // LCOV_EXCL_LINE
-                        // In case the ioctl failed, fall back to chrono. // LCOV_EXCL_LINE
-                        timestamp = std::chrono::system_clock::now(); // LCOV_EXCL_LINE
-                    }
-#else
                     std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now();
-#endif
-
-                    // Transform sender address to C-string.
-                    ::inet_ntop(remote.ss_family,
-                                &((reinterpret_cast<struct sockaddr_in *>(&remote))->sin_addr), // NOLINT
-                                remoteAddress.data(),
-                                remoteAddress.max_size());
-                    const unsigned long RECVFROM_IP{reinterpret_cast<struct sockaddr_in *>(&remote)->sin_addr.s_addr}; // NOLINT
-                    const uint16_t RECVFROM_PORT{ntohs(reinterpret_cast<struct sockaddr_in *>(&remote)->sin_port)};    // NOLINT
-
-                    // Check if the bytes actually came from us.
-                    bool sentFromUs{false};
-                    {
-                        auto pos                   = m_listOfLocalIPAddresses.find(RECVFROM_IP);
-                        const bool sentFromLocalIP = (pos != m_listOfLocalIPAddresses.end() && (*pos == RECVFROM_IP));
-                        sentFromUs                 = sentFromLocalIP && (m_localSendFromPort == RECVFROM_PORT);
-                    }
 
                     // Create a pipeline entry to be processed concurrently.
-                    if (!sentFromUs) {
+                    const struct sockaddr_in *REMOTE{reinterpret_cast<struct sockaddr_in *>(&remote)}; // NOLINT
+                    if (!isSentFromUs(*REMOTE)) {
                         PipelineEntry pe;
                         pe.m_data       = std::string(buffer.data(), static_cast<size_t>(bytesRead));
-                        pe.m_from       = std::string(remoteAddress.data()) + ':' + std::to_string(RECVFROM_PORT);
+                        pe.m_from       = *REMOTE;
                         pe.m_sampleTime = timestamp;
 
                         // Store entry in queue.
@@ -10564,6 +11622,7 @@ inline void UDPReceiver::readFromSocket() noexcept {
         }
     }
 }
+#endif
 } // namespace cluon
 /*
  * Copyright (C) 2017-2018  Christian Berger
@@ -10724,8 +11783,12 @@ inline void TCPConnection::startReadingFromSocket() noexcept {
     }
 
     try {
+        // A TCP stream must not lose bytes: block the reading thread when the pipeline is full.
+        constexpr std::size_t PIPELINE_CAPACITY{256};
         m_pipeline = std::make_shared<cluon::NotifyingPipeline<PipelineEntry>>(
-            [this](PipelineEntry &&entry) { this->m_newDataDelegate(std::move(entry.m_data), std::move(entry.m_sampleTime)); });
+            [this](PipelineEntry &&entry) { this->m_newDataDelegate(std::move(entry.m_data), std::move(entry.m_sampleTime)); },
+            PIPELINE_CAPACITY,
+            PipelineBackpressure::BLOCK);
         if (m_pipeline) {
             // Let the operating system spawn the thread.
             using namespace std::literals::chrono_literals; // NOLINT
@@ -10822,27 +11885,30 @@ inline void TCPConnection::readFromSocket() noexcept {
                 break;
             }
 
+            bool hasDelegate{false};
             {
                 std::lock_guard<std::mutex> lck(m_newDataDelegateMutex);
-                if ((0 < bytesRead) && (nullptr != m_newDataDelegate)) {
-                    // SIOCGSTAMP is not available for a stream-based socket,
-                    // thus, falling back to regular chrono timestamping.
-                    std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now();
-                    {
-                        PipelineEntry pe;
-                        pe.m_data       = std::string(buffer.data(), static_cast<size_t>(bytesRead));
-                        pe.m_sampleTime = timestamp;
-
-                        // Store entry in queue.
-                        if (m_pipeline) {
-                            m_pipeline->add(std::move(pe));
-                        }
-                    }
+                hasDelegate = (nullptr != m_newDataDelegate);
+            }
+            // Do not hold the delegate's mutex while add() might block on a full pipeline.
+            if ((0 < bytesRead) && hasDelegate) {
+                // SIOCGSTAMP is not available for a stream-based socket,
+                // thus, falling back to regular chrono timestamping.
+                std::chrono::system_clock::time_point timestamp = std::chrono::system_clock::now();
+                {
+                    PipelineEntry pe;
+                    pe.m_data       = std::string(buffer.data(), static_cast<size_t>(bytesRead));
+                    pe.m_sampleTime = timestamp;
 
+                    // Store entry in queue.
                     if (m_pipeline) {
-                        m_pipeline->notifyAll();
+                        m_pipeline->add(std::move(pe));
                     }
                 }
+
+                if (m_pipeline) {
+                    m_pipeline->notifyAll();
+                }
             }
         }
     }
@@ -11052,11 +12118,35 @@ inline void TCPServer::readFromSocket() noexcept {
 
 namespace cluon {
 
+inline ToProtoVisitor::ToProtoVisitor() noexcept
+    : m_buffer(m_ownBuffer) {}
+
+inline ToProtoVisitor::ToProtoVisitor(std::string &out) noexcept
+    : m_buffer(out)
+    , m_begin(out.size()) {}
+
 inline std::string ToProtoVisitor::encodedData() const noexcept {
-    std::string s{m_buffer.str()};
+    std::string s{m_buffer, m_begin};
     return s;
 }
 
+inline std::size_t ToProtoVisitor::encodedSize() const noexcept {
+    return m_buffer.size() - m_begin;
+}
+
+inline void ToProtoVisitor::reset() noexcept {
+    m_buffer.resize(m_begin);
+}
+
+inline void ToProtoVisitor::backPatchLength(std::size_t position, std::size_t length) noexcept {
+    std::string varInt;
+    toVarInt(varInt, length);
+    if (1 < varInt.size()) {
+        m_buffer.insert(position + 1, varInt.size() - 1, '\0');
+    }
+    m_buffer.replace(position, varInt.size(), varInt);
+}
+
 inline void ToProtoVisitor::preVisit(int32_t id, const std::string &shortName, const std::string &longName) noexcept {
     (void)id;
     (void)shortName;
@@ -11152,72 +12242,72 @@ inline void ToProtoVisitor::visit(uint32_t id, std::string &&typeName, std::stri
 
 ////////////////////////////////////////////////////////////////////////////////
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, bool &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, bool &v) noexcept {
     uint64_t _v{(v ? 1u : 0u)};
     return toVarInt(o, _v);
 }
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, int8_t &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, int8_t &v) noexcept {
     uint64_t _v = toZigZag8(v);
     return toVarInt(o, _v);
 }
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, uint8_t &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, uint8_t &v) noexcept {
     uint64_t _v = v;
     return toVarInt(o, _v);
 }
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, int16_t &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, int16_t &v) noexcept {
     uint64_t _v = toZigZag16(v);
     return toVarInt(o, _v);
 }
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, uint16_t &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, uint16_t &v) noexcept {
     uint64_t _v = v;
     return toVarInt(o, _v);
 }
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, int32_t &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, int32_t &v) noexcept {
     uint64_t _v = toZigZag32(v);
     return toVarInt(o, _v);
 }
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, uint32_t &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, uint32_t &v) noexcept {
     uint64_t _v = v;
     return toVarInt(o, _v);
 }
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, int64_t &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, int64_t &v) noexcept {
     uint64_t _v = toZigZag64(v);
     return toVarInt(o, _v);
 }
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, uint64_t &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, uint64_t &v) noexcept {
     return toVarInt(o, v);
 }
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, float &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, float &v) noexcept {
     // Store 4 bytes as little endian encoding.
     uint32_t _v{0};
     std::memmove(&_v, &v, sizeof(float));
     _v = htole32(_v);
-    o.write(reinterpret_cast<const char *>(&_v), sizeof(uint32_t)); // NOLINT
+    o.append(reinterpret_cast<const char *>(&_v), sizeof(uint32_t)); // NOLINT
     return sizeof(uint32_t);
 }
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, double &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, double &v) noexcept {
     // Store 8 bytes as little endian encoding.
     uint64_t _v{0};
     std::memmove(&_v, &v, sizeof(double));
     _v = htole64(_v);
-    o.write(reinterpret_cast<const char *>(&_v), sizeof(uint64_t)); // NOLINT
+    o.append(reinterpret_cast<const char *>(&_v), sizeof(uint64_t)); // NOLINT
     return sizeof(uint64_t);
 }
 
-inline std::size_t ToProtoVisitor::encode(std::ostream &o, const std::string &v) noexcept {
+inline std::size_t ToProtoVisitor::encode(std::string &o, const std::string &v) noexcept {
     const std::size_t LENGTH = v.length();
     std::size_t size         = toVarInt(o, LENGTH);
-    o.write(v.c_str(), static_cast<std::streamsize>(LENGTH)); // LENGTH won't be negative.
+    o.append(v);
     return size + LENGTH;
 }
 
@@ -11241,20 +12331,23 @@ inline uint64_t ToProtoVisitor::encodeKey(uint32_t fieldIdentifier, uint8_t prot
     return (fieldIdentifier << 0x3) | protoType;
 }
 
-inline std::size_t ToProtoVisitor::toVarInt(std::ostream &out, uint64_t v) noexcept {
+inline std::size_t ToProtoVisitor::toVarInt(std::string &out, uint64_t v) noexcept {
+    // A 64-bit value needs at most 10 bytes.
+    char bytes[10];
     // Minimum size is of the encoded data.
     std::size_t size{1};
     uint8_t b{0};
     while (0x7f < v) {
         // Use the MSB to indicate value overflow for more bytes to come.
         b = (static_cast<uint8_t>(v & 0x7f)) | 0x80;
-        out.put(static_cast<char>(b));
+        bytes[size - 1] = static_cast<char>(b);
         v >>= 7;
         size++;
     }
     // Write final byte.
     b = (static_cast<uint8_t>(v)) & 0x7f;
-    out.put(static_cast<char>(b));
+    bytes[size - 1] = static_cast<char>(b);
+    out.append(bytes, size);
 
     return size;
 }
@@ -11344,9 +12437,47 @@ inline void FromProtoVisitor::decodeFrom(std::istream &in) noexcept {
 
 inline FromProtoVisitor &FromProtoVisitor::operator=(const FromProtoVisitor &other) noexcept {
     m_mapOfKeyValues = other.m_mapOfKeyValues;
+    m_fieldIndex     = other.m_fieldIndex;
     return *this;
 }
 
+inline bool FromProtoVisitor::indexFrom(const char *data, std::size_t size) noexcept {
+    bool retVal{(nullptr != data) || (0 == size)};
+    const char *cursor{data};
+    const char *const END{data + size};
+
+    // Keep the capacity to index consecutive messages without allocations.
+    m_fieldIndex.clear();
+    while (retVal && (cursor < END)) {
+        const char *valueBegin{nullptr};
+        retVal = nextField(cursor, END, valueBegin);
+        if (retVal) {
+            m_fieldIndex.push_back(FieldLocation{m_fieldId, m_protoType, m_value, valueBegin});
+        }
+    }
+    if (!retVal) {
+        m_fieldIndex.clear();
+    }
+    return retVal;
+}
+
+inline bool FromProtoVisitor::hasField(uint32_t fieldId) const noexcept {
+    bool retVal{false};
+    for (const auto &e : m_fieldIndex) {
+        retVal |= (fieldId == e.fieldId);
+    }
+    return retVal;
+}
+
+inline std::vector<uint32_t> FromProtoVisitor::indexedFields() const noexcept {
+    std::vector<uint32_t> retVal;
+    retVal.reserve(m_fieldIndex.size());
+    for (const auto &e : m_fieldIndex) {
+        retVal.push_back(e.fieldId);
+    }
+    return retVal;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 inline void FromProtoVisitor::preVisit(int32_t id, const std::string &shortName, const std::string &longName) noexcept {
@@ -11537,7 +12668,7 @@ inline void FromProtoVisitor::visit(uint32_t id, std::string &&typeName, std::st
     (void)typeName;
     (void)name;
     if (m_callToDecodeFromWithDirectVisit) {
-        v = std::string(m_stringValue.data(), static_cast<std::size_t>(m_value));
+        v.assign(m_lengthDelimitedData, static_cast<std::size_t>(m_value));
     }
     else if (m_mapOfKeyValues.count(id) > 0) {
         try {
@@ -11583,7 +12714,82 @@ inline std::size_t FromProtoVisitor::fromVarInt(std::istream &in, uint64_t &valu
         }
     }
 
-    return size;
+    return size;
+}
+
+inline std::size_t FromProtoVisitor::fromVarInt(const char *&cursor, const char *end, uint64_t &value) noexcept {
+    value = 0;
+
+    constexpr uint64_t MASK  = 0x7f;
+    constexpr uint64_t SHIFT = 0x7;
+    constexpr uint64_t MSB   = 0x80;
+    constexpr std::size_t MAX_VARINT_SIZE{10};
+
+    std::size_t size = 0;
+    while ((cursor < end) && (size < MAX_VARINT_SIZE)) {
+        const uint64_t C{static_cast<uint8_t>(*cursor++)};
+        value |= (C & MASK) << (SHIFT * size++);
+        if (!(C & MSB)) { // NOLINT
+            return size;
+        }
+    }
+
+    // Truncated or overlong VarInt.
+    return 0;
+}
+
+inline bool FromProtoVisitor::nextField(const char *&cursor, const char *end, const char *&valueBegin) noexcept {
+    // First stage: Read keyFieldType (encoded as VarInt).
+    bool retVal{0 < fromVarInt(cursor, end, m_keyFieldType)};
+    if (retVal) {
+        m_protoType = static_cast<ProtoConstants>(m_keyFieldType & 0x7);
+        m_fieldId   = static_cast<uint32_t>(m_keyFieldType >> 3);
+        valueBegin  = cursor;
+        switch (m_protoType) {
+            case ProtoConstants::VARINT:
+                retVal = (0 < fromVarInt(cursor, end, m_value));
+                break;
+            case ProtoConstants::EIGHT_BYTES:
+                retVal = (static_cast<std::size_t>(end - cursor) >= sizeof(double));
+                cursor += (retVal ? sizeof(double) : 0);
+                break;
+            case ProtoConstants::FOUR_BYTES:
+                retVal = (static_cast<std::size_t>(end - cursor) >= sizeof(float));
+                cursor += (retVal ? sizeof(float) : 0);
+                break;
+            case ProtoConstants::LENGTH_DELIMITED:
+                retVal = (0 < fromVarInt(cursor, end, m_value)) && (m_value <= static_cast<uint64_t>(end - cursor));
+                if (retVal) {
+                    valueBegin = cursor;
+                    cursor += static_cast<std::size_t>(m_value);
+                }
+                break;
+            default:
+                // Groups and unknown wire types are not supported.
+                retVal = false;
+                break;
+        }
+    }
+    return retVal;
+}
+
+inline void FromProtoVisitor::loadValue(const char *valueBegin) noexcept {
+    switch (m_protoType) {
+        case ProtoConstants::EIGHT_BYTES:
+            std::memcpy(m_doubleValue.buffer.data(), valueBegin, sizeof(double));
+            m_doubleValue.uint64Value = le64toh(m_doubleValue.uint64Value);
+            break;
+        case ProtoConstants::FOUR_BYTES:
+            std::memcpy(m_floatValue.buffer.data(), valueBegin, sizeof(float));
+            m_floatValue.uint32Value = le32toh(m_floatValue.uint32Value);
+            break;
+        case ProtoConstants::LENGTH_DELIMITED:
+            m_lengthDelimitedData = valueBegin;
+            break;
+        default:
+            // VarInt values are already decoded into m_value.
+            break;
+    }
 }
 } // namespace cluon
 /*
@@ -14013,11 +15219,9 @@ inline void OD4Session::callback(std::string &&data, std::string && /*from*/, st
     }
     // Only unpack the envelope when it needs to be post-processed.
     if ((nullptr != m_delegate) || (0 < numberOfDataTriggeredDelegates)) {
-        std::stringstream sstr(data);
-        auto retVal = extractEnvelope(sstr);
-
-        if (retVal.first) {
-            cluon::data::Envelope env{retVal.second};
+        // Decode the Envelope straight from the received bytes.
+        cluon::data::Envelope env;
+        if (extractEnvelope(data.data(), data.size(), env)) {
             env.received(cluon::time::convert(timepoint));
 
             // "Catch all"-delegate.
@@ -14027,8 +15231,9 @@ inline void OD4Session::callback(std::string &&data, std::string && /*from*/, st
                 try {
                     // Data triggered-delegates.
                     std::lock_guard<std::mutex> lck{m_mapOfDataTriggeredDelegatesMutex};
-                    if (m_mapOfDataTriggeredDelegates.count(env.dataType()) > 0) {
-                        m_mapOfDataTriggeredDelegates[env.dataType()](std::move(env));
+                    auto delegate = m_mapOfDataTriggeredDelegates.find(env.dataType());
+                    if (delegate != m_mapOfDataTriggeredDelegates.end()) {
+                        delegate->second(std::move(env));
                     }
                 } catch (...) {} // LCOV_EXCL_LINE
             }
@@ -14040,7 +15245,82 @@ inline void OD4Session::send(cluon::data::Envelope &&envelope) noexcept {
     sendInternal(cluon::serializeEnvelope(std::move(envelope)));
 }
 
+inline OD4Session::~OD4Session() noexcept {
+    m_batchThreadRunning.store(false);
+    {
+        std::lock_guard<std::mutex> lck(m_batchMutex);
+        m_batchCondition.notify_all();
+    }
+    try {
+        if (m_batchThread.joinable()) {
+            m_batchThread.join();
+        }
+    } catch (...) {} // LCOV_EXCL_LINE
+
+    flush();
+}
+
+inline void OD4Session::batchSending(uint32_t maxEnvelopes, std::chrono::microseconds window) noexcept {
+    {
+        std::lock_guard<std::mutex> lck(m_batchMutex);
+        m_batchMaxEnvelopes = maxEnvelopes;
+        m_batchWindow       = window;
+        m_batch.reserve(maxEnvelopes);
+    }
+    if ((1 < maxEnvelopes) && !m_batchThreadRunning.load()) {
+        // Constructing a thread could fail.
+        try {
+            m_batchThreadRunning.store(true);
+            m_batchThread = std::thread(&OD4Session::sendBatchesWhenDue, this);
+        } catch (...) { m_batchThreadRunning.store(false); } // LCOV_EXCL_LINE
+    }
+    flush();
+}
+
+inline void OD4Session::flush() noexcept {
+    std::lock_guard<std::mutex> lck(m_batchMutex);
+    sendPendingBatch();
+}
+
+inline void OD4Session::sendPendingBatch() noexcept {
+    // Caller must hold m_batchMutex so that batches are sent in order.
+    if (!m_batch.empty()) {
+        std::vector<std::string> batch;
+        batch.reserve(m_batchMaxEnvelopes);
+        batch.swap(m_batch);
+        m_sender.sendBatch(std::move(batch));
+    }
+}
+
+inline void OD4Session::sendBatchesWhenDue() noexcept {
+    std::unique_lock<std::mutex> lck(m_batchMutex);
+    while (m_batchThreadRunning.load()) {
+        if (m_batch.empty()) {
+            m_batchCondition.wait(lck, [this] { return (!this->m_batchThreadRunning.load() || !this->m_batch.empty()); });
+        } else if (std::chrono::steady_clock::now() >= m_batchDeadline) {
+            sendPendingBatch();
+        } else {
+            m_batchCondition.wait_until(lck, m_batchDeadline);
+        }
+    }
+}
+
 inline void OD4Session::sendInternal(std::string &&dataToSend) noexcept {
+    {
+        std::lock_guard<std::mutex> lck(m_batchMutex);
+        if ((1 < m_batchMaxEnvelopes) && m_batchThreadRunning.load()) {
+            if (m_batch.empty()) {
+                // The first pending Envelope defines when the batch is due.
+                m_batchDeadline = std::chrono::steady_clock::now() + m_batchWindow;
+                m_batchCondition.notify_all();
+            }
+            m_batch.emplace_back(std::move(dataToSend));
+            if (m_batchMaxEnvelopes <= m_batch.size()) {
+                sendPendingBatch();
+            }
+            return;
+        }
+    }
     m_sender.send(std::move(dataToSend));
 }
 
@@ -14359,8 +15639,19 @@ inline std::string EnvelopeConverter::getProtoEncodedEnvelopeFromJSON(const std:
 //#include "cluon/Envelope.hpp"
 //#include "cluon/Time.hpp"
 
+// clang-format off
+#ifndef WIN32
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+// clang-format on
+
 #include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cstdlib>
 #include <cmath>
 #include <cstdio>
 #include <fstream>
@@ -14376,20 +15667,208 @@ inline IndexEntry::IndexEntry(const int64_t &sampleTimeStamp, const uint64_t &fi
     , m_filePosition(filePosition)
     , m_available(false) {}
 
+inline IndexEntry::IndexEntry(const int64_t &sampleTimeStamp, const uint64_t &filePosition, const int32_t &dataType, const uint32_t &size) noexcept
+    : m_sampleTimeStamp(sampleTimeStamp)
+    , m_filePosition(filePosition)
+    , m_dataType(dataType)
+    , m_size(size)
+    , m_available(false) {}
+
+////////////////////////////////////////////////////////////////////////
+
+inline RecIndex::RecIndex(const std::string &recFile) noexcept {
+#ifndef WIN32
+    uint64_t recFileSize{0};
+    int64_t recFileModificationTime{0};
+    if (statusOf(recFile, recFileSize, recFileModificationTime)) {
+        const std::string INDEX_FILE{indexFileFor(recFile)};
+        const int fd{::open(INDEX_FILE.c_str(), O_RDONLY)}; // NOLINT
+        if (-1 != fd) {
+            struct stat fileStatus;
+            if ((0 == ::fstat(fd, &fileStatus)) && (static_cast<off_t>(HEADER_SIZE) <= fileStatus.st_size)) {
+                const std::size_t SIZE{static_cast<std::size_t>(fileStatus.st_size)};
+                void *mappedFile = ::mmap(nullptr, SIZE, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (MAP_FAILED != mappedFile) {
+                    m_mappedFile     = static_cast<const char *>(mappedFile);
+                    m_mappedFileSize = SIZE;
+                }
+            }
+            ::close(fd);
+        }
+    }
+
+    if (nullptr != m_mappedFile) {
+        uint32_t version{0};
+        uint32_t entrySize{0};
+        uint64_t size{0};
+        uint64_t modificationTime{0};
+        uint64_t numberOfEntries{0};
+        std::memcpy(&version, m_mappedFile + 8, sizeof(uint32_t));
+        std::memcpy(&entrySize, m_mappedFile + 12, sizeof(uint32_t));
+        std::memcpy(&size, m_mappedFile + 16, sizeof(uint64_t));
+        std::memcpy(&modificationTime, m_mappedFile + 24, sizeof(uint64_t));
+        std::memcpy(&numberOfEntries, m_mappedFile + 32, sizeof(uint64_t));
+        numberOfEntries = le64toh(numberOfEntries);
+
+        const bool VALID{(0 == std::memcmp(m_mappedFile, "CLUONIDX", 8)) && (VERSION == le32toh(version)) && (ENTRY_SIZE == le32toh(entrySize))
+                         && (recFileSize == le64toh(size)) && (recFileModificationTime == static_cast<int64_t>(le64toh(modificationTime)))
+                         && (0 == (m_mappedFileSize - HEADER_SIZE) % ENTRY_SIZE) && (numberOfEntries == (m_mappedFileSize - HEADER_SIZE) / ENTRY_SIZE)};
+        if (VALID) {
+            m_numberOfEntries = numberOfEntries;
+        } else {
+            ::munmap(const_cast<char *>(m_mappedFile), m_mappedFileSize);
+            m_mappedFile     = nullptr;
+            m_mappedFileSize = 0;
+        }
+    }
+#else
+    (void)recFile;
+#endif
+}
+
+inline RecIndex::~RecIndex() noexcept {
+#ifndef WIN32
+    if (nullptr != m_mappedFile) {
+        ::munmap(const_cast<char *>(m_mappedFile), m_mappedFileSize);
+    }
+#endif
+}
+
+inline bool RecIndex::valid() const noexcept {
+    return (nullptr != m_mappedFile);
+}
+
+inline uint64_t RecIndex::size() const noexcept {
+    return m_numberOfEntries;
+}
+
+inline IndexEntry RecIndex::at(uint64_t i) const noexcept {
+    const char *entry{m_mappedFile + HEADER_SIZE + i * ENTRY_SIZE};
+    uint64_t sampleTimeStamp{0};
+    uint64_t filePosition{0};
+    uint32_t dataType{0};
+    uint32_t size{0};
+    std::memcpy(&sampleTimeStamp, entry + 0, sizeof(uint64_t));
+    std::memcpy(&filePosition, entry + 8, sizeof(uint64_t));
+    std::memcpy(&dataType, entry + 16, sizeof(uint32_t));
+    std::memcpy(&size, entry + 20, sizeof(uint32_t));
+    return IndexEntry(static_cast<int64_t>(le64toh(sampleTimeStamp)), le64toh(filePosition), static_cast<int32_t>(le32toh(dataType)), le32toh(size));
+}
+
+inline std::string RecIndex::indexFileFor(const std::string &recFile) noexcept {
+    return recFile + ".idx";
+}
+
+inline bool RecIndex::statusOf(const std::string &recFile, uint64_t &size, int64_t &modificationTime) noexcept {
+    bool retVal{false};
+#ifndef WIN32
+    struct stat fileStatus;
+    if (0 == ::stat(recFile.c_str(), &fileStatus)) {
+        constexpr int64_t ONE_SECOND_IN_NANOSECONDS{1000 * 1000 * 1000};
+        size = static_cast<uint64_t>(fileStatus.st_size);
+#ifdef __APPLE__
+        modificationTime = static_cast<int64_t>(fileStatus.st_mtimespec.tv_sec) * ONE_SECOND_IN_NANOSECONDS + static_cast<int64_t>(fileStatus.st_mtimespec.tv_nsec);
+#else
+        modificationTime = static_cast<int64_t>(fileStatus.st_mtim.tv_sec) * ONE_SECOND_IN_NANOSECONDS + static_cast<int64_t>(fileStatus.st_mtim.tv_nsec);
+#endif
+        retVal = true;
+    }
+#else
+    (void)recFile;
+    (void)size;
+    (void)modificationTime;
+#endif
+    return retVal;
+}
+
+inline bool RecIndex::write(const std::string &recFile, const std::vector<IndexEntry> &entries) noexcept {
+    bool retVal{false};
+    uint64_t recFileSize{0};
+    int64_t recFileModificationTime{0};
+    if (statusOf(recFile, recFileSize, recFileModificationTime)) {
+        std::string buffer;
+        buffer.reserve(HEADER_SIZE + entries.size() * ENTRY_SIZE);
+
+        auto append32 = [&buffer](uint32_t v) {
+            v = htole32(v);
+            buffer.append(reinterpret_cast<const char *>(&v), sizeof(uint32_t)); // NOLINT
+        };
+        auto append64 = [&buffer](uint64_t v) {
+            v = htole64(v);
+            buffer.append(reinterpret_cast<const char *>(&v), sizeof(uint64_t)); // NOLINT
+        };
+        buffer.append("CLUONIDX", 8);
+        append32(VERSION);
+        append32(ENTRY_SIZE);
+        append64(recFileSize);
+        append64(static_cast<uint64_t>(recFileModificationTime));
+        append64(static_cast<uint64_t>(entries.size()));
+        for (const auto &e : entries) {
+            append64(static_cast<uint64_t>(e.m_sampleTimeStamp));
+            append64(e.m_filePosition);
+            append32(static_cast<uint32_t>(e.m_dataType));
+            append32(e.m_size);
+        }
+
+        // Write to a temporary file of its own first so that readers never see a partial
+        // index, and so that processes or threads indexing the same recording do not
+        // truncate each other's file; the last complete index renamed wins.
+        const std::string INDEX_FILE{indexFileFor(recFile)};
+#ifndef WIN32
+        std::string temporaryFile{INDEX_FILE + ".XXXXXX"};
+        const int fd{::mkstemp(&temporaryFile[0])};
+        if (0 <= fd) {
+            // mkstemp creates the file readable by its owner only.
+            retVal = (0 == ::fchmod(fd, 0644));
+            const char *data{buffer.data()};
+            std::size_t remaining{buffer.size()};
+            while (retVal && (0 < remaining)) {
+                const ssize_t written{::write(fd, data, remaining)};
+                if (0 < written) {
+                    data += written;
+                    remaining -= static_cast<std::size_t>(written);
+                } else {
+                    retVal = (0 > written) && (EINTR == errno);
+                }
+            }
+            retVal = (0 == ::close(fd)) && retVal;
+            retVal = retVal && (0 == std::rename(temporaryFile.c_str(), INDEX_FILE.c_str()));
+            if (!retVal) {
+                std::remove(temporaryFile.c_str());
+            }
+        }
+#else
+        (void)INDEX_FILE;
+#endif
+    }
+    return retVal;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+inline EnvelopeView::EnvelopeView(const char *data, std::size_t size, int64_t sampleTimeStamp) noexcept
+    : m_data(data)
+    , m_size(size)
+    , m_sampleTimeStamp(sampleTimeStamp) {}
+
+inline bool EnvelopeView::decode(cluon::data::Envelope &envelope) const noexcept {
+    return cluon::extractEnvelope(m_data, m_size, envelope);
+}
+
 ////////////////////////////////////////////////////////////////////////
 
-inline Player::Player(const std::string &file, const bool &autoRewind, const bool &threading) noexcept
+inline Player::Player(const std::string &file, const bool &autoRewind, const bool &threading, const bool &memoryMapped) noexcept
     : m_threading(threading)
     , m_file(file)
     , m_recFile()
     , m_recFileValid(false)
+    , m_memoryMapped(memoryMapped)
     , m_autoRewind(autoRewind)
     , m_indexMutex()
     , m_index()
-    , m_previousPreviousEnvelopeAlreadyReplayed(m_index.end())
-    , m_previousEnvelopeAlreadyReplayed(m_index.begin())
-    , m_currentEnvelopeToReplay(m_index.begin())
-    , m_nextEntryToReadFromRecFile(m_index.begin())
+    , m_previousEnvelopeAlreadyReplayed(0)
+    , m_currentEnvelopeToReplay(0)
+    , m_nextEntryToReadFromRecFile(0)
     , m_desiredInitialLevel(0)
     , m_firstTimePointReturningAEnvelope()
     , m_numberOfReturnedEnvelopesInTotal(0)
@@ -14401,6 +15880,8 @@ inline Player::Player(const std::string &file, const bool &autoRewind, const boo
     , m_playerListenerMutex()
     , m_playerListener(nullptr) {
     initializeIndex();
+    // The kernel reads ahead the mapped file; no cache filling thread is needed.
+    m_threading = m_threading && !m_memoryMapped;
     computeInitialCacheLevelAndFillCache();
 
     if (m_threading) {
@@ -14418,6 +15899,11 @@ inline Player::~Player() {
     }
 
     m_recFile.close();
+#ifndef WIN32
+    if (nullptr != m_mappedFile) {
+        ::munmap(const_cast<char *>(m_mappedFile), m_mappedFileSize);
+    }
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -14430,49 +15916,221 @@ inline void Player::setPlayerListener(std::function<void(cluon::data::PlayerStat
 ////////////////////////////////////////////////////////////////////////
 
 inline void Player::initializeIndex() noexcept {
-    m_recFile.open(m_file.c_str(), std::ios_base::in | std::ios_base::binary); /* Flawfinder: ignore */
-    m_recFileValid = m_recFile.good();
+    if (m_memoryMapped) {
+        m_recFileValid = mapRecFile();
+        if (!m_recFileValid) {
+            std::clog << "[cluon::Player]: " << m_file << " could not be mapped; falling back to reading from stream." << std::endl;
+            m_memoryMapped = false;
+        }
+    }
+    if (!m_memoryMapped) {
+        m_recFile.open(m_file.c_str(), std::ios_base::in | std::ios_base::binary); /* Flawfinder: ignore */
+        m_recFileValid = m_recFile.good();
+    }
 
     if (m_recFileValid) {
-        // Determine file size to display progress.
-        m_recFile.seekg(0, m_recFile.end);
-        int64_t fileLength = m_recFile.tellg();
-        m_recFile.seekg(0, m_recFile.beg);
-
-        // Read complete file and store file positions to envelopes to create
-        // index of available data. The actual reading of Envelopes is deferred.
-        uint64_t totalBytesRead = 0;
-        const cluon::data::TimeStamp BEFORE{cluon::time::now()};
-        {
-            int32_t oldPercentage = -1;
-            while (m_recFile.good()) {
-                const uint64_t POS_BEFORE = static_cast<uint64_t>(m_recFile.tellg());
-                auto retVal               = extractEnvelope(m_recFile);
-                const uint64_t POS_AFTER  = static_cast<uint64_t>(m_recFile.tellg());
-
-                if (!m_recFile.eof() && retVal.first) {
-                    totalBytesRead += (POS_AFTER - POS_BEFORE);
-
-                    // Store mapping .rec file position --> index entry.
-                    const int64_t microseconds = cluon::time::toMicroseconds(retVal.second.sampleTimeStamp());
-                    m_index.emplace(std::make_pair(microseconds, IndexEntry(microseconds, POS_BEFORE)));
-
-                    const int32_t percentage = static_cast<int32_t>((static_cast<float>(m_recFile.tellg()) * 100.0f) / static_cast<float>(fileLength));
-                    if ((percentage % 5 == 0) && (percentage != oldPercentage)) {
-                        std::clog << "[cluon::Player]: Indexed " << percentage << "% from " << m_file << "." << std::endl;
-                        oldPercentage = percentage;
-                    }
-                }
+        if (!initializeIndexFromRecIndex()) {
+            if (m_memoryMapped) {
+                initializeIndexFromMappedFile();
+            } else {
+                initializeIndexFromRecFile();
+            }
+            // Sort chronologically; entries with the same sample time stamp keep their order from the file.
+            std::stable_sort(m_index.begin(), m_index.end(), [](const IndexEntry &a, const IndexEntry &b) { return a.m_sampleTimeStamp < b.m_sampleTimeStamp; });
+
+            // Persist the index to skip the scan next time; failing to write it is not an error.
+            if (cluon::RecIndex::write(m_file, m_index)) {
+                std::clog << "[cluon::Player]: Wrote index " << cluon::RecIndex::indexFileFor(m_file) << "." << std::endl;
             }
         }
+    } else {
+        std::clog << "[cluon::Player]: " << m_file << " could not be opened." << std::endl;
+    }
+}
+
+inline bool Player::initializeIndexFromRecIndex() noexcept {
+    const cluon::data::TimeStamp BEFORE{cluon::time::now()};
+    cluon::RecIndex recIndex(m_file);
+    if (recIndex.valid()) {
+        // Entries are sorted already.
+        m_index.reserve(static_cast<std::size_t>(recIndex.size()));
+        for (uint64_t i{0}; i < recIndex.size(); i++) {
+            m_index.push_back(recIndex.at(i));
+        }
         const cluon::data::TimeStamp AFTER{cluon::time::now()};
 
         std::clog << "[cluon::Player]: " << m_file << " contains " << m_index.size() << " entries; "
-                  << "read " << totalBytesRead << " bytes "
-                  << "in " << cluon::time::deltaInMicroseconds(AFTER, BEFORE) / static_cast<int64_t>(1000 * 1000) << "s." << std::endl;
-    } else {
-        std::clog << "[cluon::Player]: " << m_file << " could not be opened." << std::endl;
+                  << "loaded index " << cluon::RecIndex::indexFileFor(m_file) << " "
+                  << "in " << cluon::time::deltaInMicroseconds(AFTER, BEFORE) / static_cast<int64_t>(1000) << "ms." << std::endl;
+    }
+    return recIndex.valid();
+}
+
+inline void Player::initializeIndexFromRecFile() noexcept {
+    // Determine file size to display progress.
+    m_recFile.seekg(0, m_recFile.end);
+    int64_t fileLength = m_recFile.tellg();
+    m_recFile.seekg(0, m_recFile.beg);
+
+    // Read complete file and store file positions to envelopes to create
+    // index of available data. The actual reading of Envelopes is deferred.
+    uint64_t totalBytesRead = 0;
+    const cluon::data::TimeStamp BEFORE{cluon::time::now()};
+    {
+        int32_t oldPercentage = -1;
+        while (m_recFile.good()) {
+            const uint64_t POS_BEFORE = static_cast<uint64_t>(m_recFile.tellg());
+            auto retVal               = extractEnvelope(m_recFile);
+            const uint64_t POS_AFTER  = static_cast<uint64_t>(m_recFile.tellg());
+
+            if (!m_recFile.eof() && retVal.first) {
+                totalBytesRead += (POS_AFTER - POS_BEFORE);
+
+                // Store mapping .rec file position --> index entry.
+                const int64_t microseconds = cluon::time::toMicroseconds(retVal.second.sampleTimeStamp());
+                m_index.emplace_back(microseconds, POS_BEFORE, retVal.second.dataType(), static_cast<uint32_t>(POS_AFTER - POS_BEFORE));
+
+                const int32_t percentage = static_cast<int32_t>((static_cast<float>(m_recFile.tellg()) * 100.0f) / static_cast<float>(fileLength));
+                if ((percentage % 5 == 0) && (percentage != oldPercentage)) {
+                    std::clog << "[cluon::Player]: Indexed " << percentage << "% from " << m_file << "." << std::endl;
+                    oldPercentage = percentage;
+                }
+            }
+        }
+    }
+    const cluon::data::TimeStamp AFTER{cluon::time::now()};
+
+    std::clog << "[cluon::Player]: " << m_file << " contains " << m_index.size() << " entries; "
+              << "read " << totalBytesRead << " bytes "
+              << "in " << cluon::time::deltaInMicroseconds(AFTER, BEFORE) / static_cast<int64_t>(1000 * 1000) << "s." << std::endl;
+}
+
+inline bool Player::mapRecFile() noexcept {
+#ifndef WIN32
+    const int fd{::open(m_file.c_str(), O_RDONLY)}; // NOLINT
+    if (-1 != fd) {
+        struct stat fileStatus;
+        if ((0 == ::fstat(fd, &fileStatus)) && (0 < fileStatus.st_size)) {
+            const std::size_t SIZE{static_cast<std::size_t>(fileStatus.st_size)};
+            void *mappedFile = ::mmap(nullptr, SIZE, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (MAP_FAILED != mappedFile) {
+                // Indexing and replay both walk the file front to back.
+                ::madvise(mappedFile, SIZE, MADV_SEQUENTIAL);
+                m_mappedFile     = static_cast<const char *>(mappedFile);
+                m_mappedFileSize = SIZE;
+            }
+        }
+        ::close(fd);
+    }
+#endif
+    return (nullptr != m_mappedFile);
+}
+
+inline void Player::initializeIndexFromMappedFile() noexcept {
+    // Index the file in place; only the fields dataType and sampleTimeStamp
+    // of each Envelope are decoded whereas the payload is skipped.
+    constexpr uint32_t DATA_TYPE_FIELD_ID{1};
+    constexpr uint32_t SAMPLE_TIME_STAMP_FIELD_ID{5};
+    cluon::FromProtoVisitor protoDecoder;
+    cluon::data::Envelope env;
+
+    uint64_t totalBytesRead = 0;
+    const cluon::data::TimeStamp BEFORE{cluon::time::now()};
+    {
+        int32_t oldPercentage = -1;
+        uint64_t position{0};
+        while ((position + OD4_HEADER_SIZE) <= m_mappedFileSize) {
+            const uint64_t POS_BEFORE{position};
+            const char *header{m_mappedFile + position};
+            position += OD4_HEADER_SIZE;
+            if ((0x0D != static_cast<uint8_t>(header[0])) || (0xA4 != static_cast<uint8_t>(header[1]))) {
+                // Skip the corrupt header like the stream-based reader does.
+                continue;
+            }
+            uint32_t length{0};
+            std::memcpy(&length, &header[1], sizeof(uint32_t));
+            const uint32_t LENGTH{le32toh(length) >> 8};
+            if (LENGTH > (m_mappedFileSize - position)) {
+                // Truncated last Envelope.
+                break;
+            }
+            position += LENGTH;
+
+            env.dataType(0).sampleTimeStamp(cluon::data::TimeStamp());
+            if (protoDecoder.indexFrom(header + OD4_HEADER_SIZE, LENGTH)) {
+                protoDecoder.decodeField(DATA_TYPE_FIELD_ID, env);
+                protoDecoder.decodeField(SAMPLE_TIME_STAMP_FIELD_ID, env);
+                totalBytesRead += (position - POS_BEFORE);
+
+                // Store mapping .rec file position --> index entry.
+                const int64_t microseconds = cluon::time::toMicroseconds(env.sampleTimeStamp());
+                m_index.emplace_back(microseconds, POS_BEFORE, env.dataType(), static_cast<uint32_t>(position - POS_BEFORE));
+
+                const int32_t percentage = static_cast<int32_t>((static_cast<float>(position) * 100.0f) / static_cast<float>(m_mappedFileSize));
+                if ((percentage % 5 == 0) && (percentage != oldPercentage)) {
+                    std::clog << "[cluon::Player]: Indexed " << percentage << "% from " << m_file << "." << std::endl;
+                    oldPercentage = percentage;
+                }
+            }
+        }
+    }
+    const cluon::data::TimeStamp AFTER{cluon::time::now()};
+
+    std::clog << "[cluon::Player]: " << m_file << " contains " << m_index.size() << " entries; "
+              << "mapped " << totalBytesRead << " bytes "
+              << "in " << cluon::time::deltaInMicroseconds(AFTER, BEFORE) / static_cast<int64_t>(1000 * 1000) << "s." << std::endl;
+}
+
+inline cluon::EnvelopeView Player::viewAt(const uint64_t &filePosition) const noexcept {
+    cluon::EnvelopeView view;
+    if ((filePosition <= m_mappedFileSize) && (OD4_HEADER_SIZE <= (m_mappedFileSize - filePosition))) {
+        const char *header{m_mappedFile + filePosition};
+        uint32_t length{0};
+        std::memcpy(&length, &header[1], sizeof(uint32_t));
+        // Entries loaded from an .idx sidecar are only checked against the
+        // recording's size and mtime; never hand out a view past the mapping.
+        const std::size_t LENGTH{le32toh(length) >> 8};
+        if (LENGTH <= (m_mappedFileSize - filePosition - OD4_HEADER_SIZE)) {
+            view.m_data = header;
+            view.m_size = OD4_HEADER_SIZE + LENGTH;
+        }
+    }
+    return view;
+}
+
+inline uint32_t Player::prefetchMappedEntries(const uint32_t &maxNumberOfEntriesToPrefetch) noexcept {
+    uint32_t entriesPrefetched = 0;
+#ifndef WIN32
+    if (m_recFileValid && (maxNumberOfEntriesToPrefetch > 0)) {
+        // Advise the kernel once for the file range covering all entries.
+        uint64_t begin{(std::numeric_limits<uint64_t>::max)()};
+        uint64_t end{0};
+        {
+            std::lock_guard<std::mutex> lck(m_indexMutex);
+            while ((m_nextEntryToReadFromRecFile < m_index.size()) && (entriesPrefetched < maxNumberOfEntriesToPrefetch)) {
+                IndexEntry &entry = m_index[m_nextEntryToReadFromRecFile];
+                begin             = (std::min)(begin, entry.m_filePosition);
+                end               = (std::max)(end, entry.m_filePosition + viewAt(entry.m_filePosition).m_size);
+                entry.m_available = true;
+
+                m_nextEntryToReadFromRecFile++;
+                entriesPrefetched++;
+            }
+        }
+        if (begin < end) {
+            static const uint64_t BYTES_PER_PAGE{static_cast<uint64_t>(::sysconf(_SC_PAGESIZE))};
+            begin -= (begin % BYTES_PER_PAGE);
+            ::madvise(const_cast<char *>(m_mappedFile) + begin, static_cast<std::size_t>(end - begin), MADV_WILLNEED);
+        }
     }
+#else
+    (void)maxNumberOfEntriesToPrefetch;
+#endif
+    return entriesPrefetched;
+}
+
+inline bool Player::isMemoryMapped() const noexcept {
+    return m_memoryMapped;
 }
 
 inline void Player::resetCaches() noexcept {
@@ -14480,7 +16138,9 @@ inline void Player::resetCaches() noexcept {
         std::lock_guard<std::mutex> lck(m_indexMutex);
         m_delay                            = 0;
         m_numberOfReturnedEnvelopesInTotal = 0;
-        m_envelopeCache.clear();
+        // Drop all cached payloads; the ring buffer is only needed without memory mapping.
+        const std::size_t CAPACITY{m_memoryMapped ? 0 : (std::max<std::size_t>)(1, (std::min<std::size_t>)(m_index.size(), Player::CACHE_CAPACITY_FACTOR * m_desiredInitialLevel))};
+        std::vector<cluon::data::Envelope>(CAPACITY).swap(m_envelopeCache);
     } catch (...) {} // LCOV_EXCL_LINE
 }
 
@@ -14488,20 +16148,19 @@ inline void Player::resetIterators() noexcept {
     try {
         std::lock_guard<std::mutex> lck(m_indexMutex);
         // Point to first entry in index.
-        m_nextEntryToReadFromRecFile = m_previousEnvelopeAlreadyReplayed = m_currentEnvelopeToReplay = m_index.begin();
-        // Invalidate iterator for erasing entries point.
-        m_previousPreviousEnvelopeAlreadyReplayed = m_index.end();
+        m_nextEntryToReadFromRecFile = m_previousEnvelopeAlreadyReplayed = m_currentEnvelopeToReplay = 0;
     } catch (...) {} // LCOV_EXCL_LINE
 }
 
+inline uint32_t Player::numberOfCachedEntries() const noexcept {
+    return static_cast<uint32_t>(m_nextEntryToReadFromRecFile - m_currentEnvelopeToReplay);
+}
+
 inline void Player::computeInitialCacheLevelAndFillCache() noexcept {
     if (m_recFileValid && (m_index.size() > 0)) {
-        int64_t smallestSampleTimePoint = (std::numeric_limits<int64_t>::max)();
-        int64_t largestSampleTimePoint  = (std::numeric_limits<int64_t>::min)();
-        for (auto it = m_index.begin(); it != m_index.end(); it++) {
-            smallestSampleTimePoint = (std::min)(smallestSampleTimePoint, it->first);
-            largestSampleTimePoint  = (std::max)(largestSampleTimePoint, it->first);
-        }
+        // The index is sorted by sample time stamp.
+        const int64_t smallestSampleTimePoint = m_index.front().m_sampleTimeStamp;
+        const int64_t largestSampleTimePoint  = m_index.back().m_sampleTimeStamp;
 
         const uint32_t ENTRIES_TO_READ_PER_SECOND_FOR_REALTIME_REPLAY
             = static_cast<uint32_t>(std::ceil(static_cast<float>(m_index.size()) * (static_cast<float>(Player::ONE_SECOND_IN_MICROSECONDS))
@@ -14517,14 +16176,28 @@ inline void Player::computeInitialCacheLevelAndFillCache() noexcept {
 }
 
 inline uint32_t Player::fillEnvelopeCache(const uint32_t &maxNumberOfEntriesToReadFromFile) noexcept {
+    if (m_memoryMapped) {
+        // Envelopes are parsed from the mapped file on demand; only prefetch their pages.
+        return prefetchMappedEntries(maxNumberOfEntriesToReadFromFile);
+    }
+
     uint32_t entriesReadFromFile = 0;
     if (m_recFileValid && (maxNumberOfEntriesToReadFromFile > 0)) {
         // Reset any fstream's error states.
         m_recFile.clear();
 
-        while ((m_nextEntryToReadFromRecFile != m_index.end()) && (entriesReadFromFile < maxNumberOfEntriesToReadFromFile)) {
+        // Only the replaying side frees slots in the ring buffer; hence, the
+        // number of free slots can only grow while filling.
+        uint32_t freeSlots{0};
+        try {
+            std::lock_guard<std::mutex> lck(m_indexMutex);
+            freeSlots = static_cast<uint32_t>(m_envelopeCache.size()) - numberOfCachedEntries();
+        } catch (...) {} // LCOV_EXCL_LINE
+
+        const uint32_t MAX_ENTRIES{(std::min)(maxNumberOfEntriesToReadFromFile, freeSlots)};
+        while ((m_nextEntryToReadFromRecFile < m_index.size()) && (entriesReadFromFile < MAX_ENTRIES)) {
             // Move to corresponding position in the .rec file.
-            m_recFile.seekg(static_cast<std::streamoff>(m_nextEntryToReadFromRecFile->second.m_filePosition));
+            m_recFile.seekg(static_cast<std::streamoff>(m_index[m_nextEntryToReadFromRecFile].m_filePosition));
 
             // Read the corresponding cluon::data::Envelope.
             auto retVal = extractEnvelope(m_recFile);
@@ -14532,11 +16205,11 @@ inline uint32_t Player::fillEnvelopeCache(const uint32_t &maxNumberOfEntriesToRe
                 // Store the envelope in the envelope cache.
                 try {
                     std::lock_guard<std::mutex> lck(m_indexMutex);
-                    m_nextEntryToReadFromRecFile->second.m_available
-                        = m_envelopeCache.emplace(std::make_pair(m_nextEntryToReadFromRecFile->second.m_filePosition, retVal.second)).second;
+                    m_envelopeCache[m_nextEntryToReadFromRecFile % m_envelopeCache.size()] = std::move(retVal.second);
+                    m_index[m_nextEntryToReadFromRecFile].m_available                      = true;
+                    m_nextEntryToReadFromRecFile++;
                 } catch (...) {} // LCOV_EXCL_LINE
 
-                m_nextEntryToReadFromRecFile++;
                 entriesReadFromFile++;
             }
         }
@@ -14549,8 +16222,16 @@ inline std::pair<bool, cluon::data::Envelope> Player::getNextEnvelopeToBeReplaye
     bool hasEnvelopeToReturn{false};
     cluon::data::Envelope envelopeToReturn;
 
+    if (m_memoryMapped) {
+        auto view = getNextEnvelopeViewToBeReplayed();
+        if (view.first) {
+            hasEnvelopeToReturn = view.second.decode(envelopeToReturn);
+        }
+        return std::make_pair(hasEnvelopeToReturn, envelopeToReturn);
+    }
+
     // If at "EOF", either throw exception or autorewind.
-    if (m_currentEnvelopeToReplay == m_index.end()) {
+    if (m_currentEnvelopeToReplay == m_index.size()) {
         if (!m_autoRewind) {
             return std::make_pair(hasEnvelopeToReturn, envelopeToReturn);
         } else {
@@ -14558,28 +16239,20 @@ inline std::pair<bool, cluon::data::Envelope> Player::getNextEnvelopeToBeReplaye
         }
     }
 
-    if (m_currentEnvelopeToReplay != m_index.end()) {
+    if (m_currentEnvelopeToReplay < m_index.size()) {
         checkAvailabilityOfNextEnvelopeToBeReplayed();
 
         try {
             {
                 std::lock_guard<std::mutex> lck(m_indexMutex);
 
-                cluon::data::Envelope &nextEnvelope = m_envelopeCache[m_currentEnvelopeToReplay->second.m_filePosition];
-                envelopeToReturn                    = nextEnvelope;
-
-                m_delay = static_cast<uint32_t>(m_currentEnvelopeToReplay->first - m_previousEnvelopeAlreadyReplayed->first);
+                // Moving the envelope out of the ring buffer frees its slot.
+                envelopeToReturn = std::move(m_envelopeCache[m_currentEnvelopeToReplay % m_envelopeCache.size()]);
+                m_index[m_currentEnvelopeToReplay].m_available = false;
 
-                // TODO: Delegate deleting into own thread.
-                if (m_previousPreviousEnvelopeAlreadyReplayed != m_index.end()) {
-                    auto it = m_envelopeCache.find(m_previousEnvelopeAlreadyReplayed->second.m_filePosition);
-                    if (it != m_envelopeCache.end()) {
-                        m_envelopeCache.erase(it);
-                    }
-                }
+                m_delay = static_cast<uint32_t>(m_index[m_currentEnvelopeToReplay].m_sampleTimeStamp - m_index[m_previousEnvelopeAlreadyReplayed].m_sampleTimeStamp);
 
-                m_previousPreviousEnvelopeAlreadyReplayed = m_previousEnvelopeAlreadyReplayed;
-                m_previousEnvelopeAlreadyReplayed         = m_currentEnvelopeToReplay++;
+                m_previousEnvelopeAlreadyReplayed = m_currentEnvelopeToReplay++;
 
                 m_numberOfReturnedEnvelopesInTotal++;
             }
@@ -14598,13 +16271,58 @@ inline std::pair<bool, cluon::data::Envelope> Player::getNextEnvelopeToBeReplaye
     return std::make_pair(hasEnvelopeToReturn, envelopeToReturn);
 }
 
+inline std::pair<bool, cluon::EnvelopeView> Player::getNextEnvelopeViewToBeReplayed() noexcept {
+    bool hasEnvelopeToReturn{false};
+    cluon::EnvelopeView viewToReturn;
+    if (!m_memoryMapped) {
+        return std::make_pair(hasEnvelopeToReturn, viewToReturn);
+    }
+
+    // If at "EOF", either stop or autorewind.
+    if (m_currentEnvelopeToReplay == m_index.size()) {
+        if (!m_autoRewind) {
+            return std::make_pair(hasEnvelopeToReturn, viewToReturn);
+        } else {
+            rewind();
+        }
+    }
+
+    if (m_currentEnvelopeToReplay < m_index.size()) {
+        uint32_t numberOfPrefetchedEntries{0};
+        try {
+            std::lock_guard<std::mutex> lck(m_indexMutex);
+
+            const IndexEntry &entry        = m_index[m_currentEnvelopeToReplay];
+            viewToReturn                   = viewAt(entry.m_filePosition);
+            viewToReturn.m_sampleTimeStamp = entry.m_sampleTimeStamp;
+
+            m_delay = static_cast<uint32_t>(entry.m_sampleTimeStamp - m_index[m_previousEnvelopeAlreadyReplayed].m_sampleTimeStamp);
+
+            m_previousEnvelopeAlreadyReplayed = m_currentEnvelopeToReplay++;
+            // Keep the prefetched range from lagging behind after seeking.
+            m_nextEntryToReadFromRecFile = (std::max)(m_nextEntryToReadFromRecFile, m_currentEnvelopeToReplay);
+
+            m_numberOfReturnedEnvelopesInTotal++;
+            numberOfPrefetchedEntries = numberOfCachedEntries();
+
+            hasEnvelopeToReturn = (nullptr != viewToReturn.m_data);
+        } catch (...) {} // LCOV_EXCL_LINE
+
+        // Prefetch in batches to keep the number of madvise calls low.
+        if (numberOfPrefetchedEntries < 0.35 * m_desiredInitialLevel) {
+            fillEnvelopeCache(m_desiredInitialLevel);
+        }
+    }
+    return std::make_pair(hasEnvelopeToReturn, viewToReturn);
+}
+
 inline void Player::checkAvailabilityOfNextEnvelopeToBeReplayed() noexcept {
     uint64_t numberOfEntries = 0;
     do {
         {
             try {
                 std::lock_guard<std::mutex> lck(m_indexMutex);
-                numberOfEntries = m_envelopeCache.size();
+                numberOfEntries = numberOfCachedEntries();
             } catch (...) {} // LCOV_EXCL_LINE
         }
         if (0 == numberOfEntries) {
@@ -14645,56 +16363,54 @@ inline void Player::rewind() noexcept {
 
 inline void Player::seekTo(float ratio) noexcept {
     if (!(ratio < 0) && !(ratio > 1)) {
-        bool enableThreading = m_threading;
-        if (m_threading) {
-            // Stop concurrent thread.
-            setEnvelopeCacheFillingRunning(false);
-            m_envelopeCacheFillingThread.join();
-        }
+        const std::size_t NUMBER_OF_ENTRIES{m_index.size()};
+        std::clog << "[cluon::Player]: Seeking to " << static_cast<float>(NUMBER_OF_ENTRIES) * ratio << "/" << NUMBER_OF_ENTRIES << std::endl;
 
-        // Read data sequentially.
-        m_threading = false;
+        // The last entry remains to be replayed when seeking to the end.
+        std::size_t entry{static_cast<std::size_t>(static_cast<float>(NUMBER_OF_ENTRIES) * ratio)};
+        entry = (0 < NUMBER_OF_ENTRIES) ? (std::min)(entry, NUMBER_OF_ENTRIES - 1) : 0;
+        seekToEntry(entry);
+    }
+}
 
-        resetCaches();
-        resetIterators();
+inline void Player::seekTo(const cluon::data::TimeStamp &sampleTimeStamp) noexcept {
+    const int64_t MICROSECONDS{cluon::time::toMicroseconds(sampleTimeStamp)};
+    auto it = std::lower_bound(
+        m_index.begin(), m_index.end(), MICROSECONDS, [](const IndexEntry &e, const int64_t &timeStamp) { return e.m_sampleTimeStamp < timeStamp; });
+    std::clog << "[cluon::Player]: Seeking to " << (it - m_index.begin()) << "/" << m_index.size() << std::endl;
+    seekToEntry(static_cast<std::size_t>(it - m_index.begin()));
+}
 
-        uint32_t numberOfEntriesInIndex = 0;
-        try {
-            std::lock_guard<std::mutex> lck(m_indexMutex);
-            numberOfEntriesInIndex = static_cast<uint32_t>(m_index.size());
-        } catch (...) {} // LCOV_EXCL_LINE
+inline void Player::seekToEntry(std::size_t entry) noexcept {
+    bool enableThreading = m_threading;
+    if (m_threading) {
+        // Stop concurrent thread.
+        setEnvelopeCacheFillingRunning(false);
+        m_envelopeCacheFillingThread.join();
+    }
 
-        // Fast forward.
-        m_numberOfReturnedEnvelopesInTotal = 0;
-        std::clog << "[cluon::Player]: Seeking to " << static_cast<float>(numberOfEntriesInIndex) * ratio << "/" << numberOfEntriesInIndex << std::endl;
-        if (0 < ratio) {
-            for (m_numberOfReturnedEnvelopesInTotal = 0;
-                 m_numberOfReturnedEnvelopesInTotal < static_cast<uint32_t>(static_cast<float>(numberOfEntriesInIndex) * ratio) - 1;
-                 m_numberOfReturnedEnvelopesInTotal++) {
-                m_currentEnvelopeToReplay++;
-            }
-        }
-        try {
-            std::lock_guard<std::mutex> lck(m_indexMutex);
-            m_nextEntryToReadFromRecFile = m_previousEnvelopeAlreadyReplayed = m_currentEnvelopeToReplay;
-        } catch (...) {} // LCOV_EXCL_LINE
+    // Read data sequentially.
+    m_threading = false;
 
-        // Refill cache.
-        m_envelopeCache.clear();
-        fillEnvelopeCache(static_cast<uint32_t>(static_cast<float>(m_desiredInitialLevel) * .3f));
+    resetCaches();
+    try {
+        std::lock_guard<std::mutex> lck(m_indexMutex);
+        // Continue from the given entry; the delay is computed relative to its predecessor.
+        m_currentEnvelopeToReplay          = (std::min)(entry, m_index.size());
+        m_previousEnvelopeAlreadyReplayed  = (0 < m_currentEnvelopeToReplay) ? m_currentEnvelopeToReplay - 1 : 0;
+        m_nextEntryToReadFromRecFile       = m_currentEnvelopeToReplay;
+        m_numberOfReturnedEnvelopesInTotal = m_currentEnvelopeToReplay;
+    } catch (...) {} // LCOV_EXCL_LINE
 
-        // Correct iterators if not at the beginning.
-        if ((0 < ratio) && (ratio < 1)) {
-            getNextEnvelopeToBeReplayed();
-        }
-        std::clog << "[cluon::Player]: Seeking done." << std::endl;
+    // Refill cache.
+    fillEnvelopeCache(static_cast<uint32_t>(static_cast<float>(m_desiredInitialLevel) * .3f));
+    std::clog << "[cluon::Player]: Seeking done." << std::endl;
 
-        if (enableThreading) {
-            m_threading = enableThreading;
-            // Re-start concurrent thread.
-            setEnvelopeCacheFillingRunning(true);
-            m_envelopeCacheFillingThread = std::thread(&Player::manageCache, this);
-        }
+    if (enableThreading) {
+        m_threading = enableThreading;
+        // Re-start concurrent thread.
+        setEnvelopeCacheFillingRunning(true);
+        m_envelopeCacheFillingThread = std::thread(&Player::manageCache, this);
     }
 }
 
@@ -14707,7 +16423,7 @@ inline bool Player::hasMoreDataFromRecFile() const noexcept {
     // File must be successfully opened AND
     //  the Player must be configured as m_autoRewind OR
     //  some entries are left to replay.
-    return (m_recFileValid && (m_autoRewind || (m_currentEnvelopeToReplay != m_index.end())));
+    return (m_recFileValid && (m_autoRewind || (m_currentEnvelopeToReplay < m_index.size())));
 }
 
 ////////////////////////////////////////////////////////////////////////
@@ -14730,7 +16446,7 @@ inline void Player::manageCache() noexcept {
     while (isEnvelopeCacheFillingRunning()) {
         try {
             std::lock_guard<std::mutex> lck(m_indexMutex);
-            numberOfEntries = static_cast<uint32_t>(m_envelopeCache.size());
+            numberOfEntries = numberOfCachedEntries();
         } catch (...) {} // LCOV_EXCL_LINE
 
         // Check if refilling of the cache is needed.
@@ -14774,7 +16490,7 @@ inline float Player::checkRefillingCache(const uint32_t &numberOfEntries, float
         const uint32_t entriesReadFromFile = fillEnvelopeCache(static_cast<uint32_t>(refillMultiplicator * static_cast<float>(m_desiredInitialLevel)));
         if (entriesReadFromFile > 0) {
             std::clog << "[cluon::Player]: Number of entries in cache: " << numberOfEntries << ". " << entriesReadFromFile << " added to cache. "
-                      << m_envelopeCache.size() << " entries available." << std::endl;
+                      << (numberOfEntries + entriesReadFromFile) << " entries available." << std::endl;
             refillMultiplicator *= 1.25f;
         }
     }
@@ -17792,7 +19508,8 @@ inline int32_t cluon_replay(int32_t argc, char **argv) {
             }
             constexpr bool AUTOREWIND{false};
             constexpr bool THREADING{true};
-            cluon::Player player(recFile, AUTOREWIND, THREADING);
+            constexpr bool MEMORY_MAPPED{true};
+            cluon::Player player(recFile, AUTOREWIND, THREADING, MEMORY_MAPPED);
             player.setPlayerListener([&playerStatusUpdate, &playerStatusMutex, &playerStatus](cluon::data::PlayerStatus &&ps){
                 {
                     std::lock_guard<std::mutex> lck(playerStatusMutex);
@@ -18218,7 +19935,8 @@ inline int32_t cluon_rec2csv(int32_t argc, char **argv) {
 
             constexpr const bool AUTOREWIND{false};
             constexpr const bool THREADING{false};
-            cluon::Player player(commandlineArguments["rec"], AUTOREWIND, THREADING);
+            constexpr const bool MEMORY_MAPPED{true};
+            cluon::Player player(commandlineArguments["rec"], AUTOREWIND, THREADING, MEMORY_MAPPED);
 
             constexpr const size_t TEN_MB{10*1024*1024};
             uint32_t envelopeCounter{0};
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONE_SEGMENTATION_HPP
+#define CONE_SEGMENTATION_HPP
+
+#include "specialized-pipeline.hpp"
+#include "stage-profiler.hpp"
+#include "steering-config.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Shortcuts that trade detection quality for time when frames would otherwise
+// miss their deadline; the default is the full detection.
+struct ProcessingQuality {
+  bool halfResolution{false}; // segment every second pixel of every second row
+  bool morphology{true};      // blur, dilate and erode the thresholded image
+};
+
+// Thresholds a region in HSV and finds the outer shapes of the matching blobs.
+class ConeSegmentation {
+ public:
+  // Increase whenever the masks of the full detection change, in the generic
+  // path or in the specialized kernels, which must stay identical to it; the
+  // cached features of older versions are then computed again.
+  enum : uint32_t { OUTPUT_VERSION = 1 };
+
+  const std::vector<std::vector<cv::Point>> &detect(const cv::Mat &region, const HsvRange &range, bool regionIsHsv) {
+    std::size_t pixels{region.total()};
+    const SpecializedKernels *kernels{specializedKernels(region, range, regionIsHsv)};
+    if (nullptr != kernels) {
+      {
+        // Conversion and threshold are one pass, charged to cvtColor
+        StageTimer timer{m_profiler, PipelineStage::CVT_COLOR, pixels};
+        kernels->threshold(region, m_paddedImg);
+      }
+      StageTimer timer{m_profiler, PipelineStage::BLUR_AND_MORPH, pixels};
+      kernels->filter(m_paddedImg, m_detectImg, m_filterScratch);
+    } else {
+      pixels = threshold(region, range, regionIsHsv);
+    }
+    StageTimer timer{m_profiler, PipelineStage::FIND_CONTOURS, pixels};
+    cv::findContours(m_detectImg, m_contours, m_hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
+    return m_contours;
+  }
+
+  // Use the kernels of PipelineRegistry for the regions they were compiled
+  // for (the default); false always takes the generic path, e.g. to compare.
+  void setSpecialized(bool specialized) noexcept {
+    m_specialized = specialized;
+  }
+
+  // Shortcuts for the following regions.
+  void setQuality(const ProcessingQuality &quality) noexcept {
+    m_quality = quality;
+  }
+
+  const ProcessingQuality &quality() const noexcept {
+    return m_quality;
+  }
+
+  // Charge the time of the segmentation steps to profiler; nullptr to stop.
+  void setProfiler(StageProfiler *profiler) noexcept {
+    m_profiler = profiler;
+  }
+
+  StageProfiler *profiler() const noexcept {
+    return m_profiler;
+  }
+
+  const std::vector<cv::Vec4i> &hierarchy() const noexcept {
+    return m_hierarchy;
+  }
+
+  // Size of the thresholded image of the last region.
+  cv::Size size() const noexcept {
+    return cv::Size(m_detectImg.cols, m_detectImg.rows);
+  }
+
+ private:
+  // The kernels only implement the full detection of BGR(A) regions.
+  const SpecializedKernels *specializedKernels(const cv::Mat &region, const HsvRange &range, bool regionIsHsv) const noexcept {
+    if (!m_specialized || regionIsHsv || m_quality.halfResolution || !m_quality.morphology) {
+      return nullptr;
+    }
+    return PipelineRegistry::find(region, range);
+  }
+
+  // The generic path with OpenCV into m_detectImg; returns its number of pixels.
+  std::size_t threshold(const cv::Mat &region, const HsvRange &range, bool regionIsHsv) {
+    const cv::Mat *input{&region};
+    if (m_quality.halfResolution || !regionIsHsv) {
+      // Downscaling is charged to cvtColor, the step it saves the most time in;
+      // nearest neighbour keeps the hue of HSV pixels intact
+      StageTimer timer{m_profiler, PipelineStage::CVT_COLOR, region.total()};
+      if (m_quality.halfResolution) {
+        cv::resize(region, m_smallImg, cv::Size(), 0.5, 0.5, cv::INTER_NEAREST);
+        input = &m_smallImg;
+      }
+      if (!regionIsHsv) {
+        cv::cvtColor(*input, m_hsvImg, cv::COLOR_BGR2HSV);
+        input = &m_hsvImg;
+      }
+    }
+    {
+      StageTimer timer{m_profiler, PipelineStage::IN_RANGE, input->total()};
+      cv::inRange(*input, cv::Scalar(range.minHue, range.minSat, range.minValue), cv::Scalar(range.maxHue, range.maxSat, range.maxValue), m_detectImg);
+    }
+    if (m_quality.morphology) {
+      // Blur, then dilate and erode; the kernel argument 0 is a 1x1 kernel, with
+      // which dilate and erode copy the image. The detection was tuned so, and
+      // the specialized kernels compute the same, so keep it as is
+      StageTimer timer{m_profiler, PipelineStage::BLUR_AND_MORPH, input->total()};
+      cv::GaussianBlur(m_detectImg, m_detectImg, cv::Size(5, 5), 0);
+      cv::dilate(m_detectImg, m_detectImg, 0);
+      cv::erode(m_detectImg, m_detectImg, 0);
+    }
+    return input->total();
+  }
+
+ private:
+  // Reused between frames to avoid reallocations
+  cv::Mat m_smallImg{};
+  cv::Mat m_hsvImg{};
+  cv::Mat m_paddedImg{};
+  cv::Mat m_detectImg{};
+  std::vector<uint8_t> m_filterScratch{};
+  std::vector<std::vector<cv::Point>> m_contours{};
+  std::vector<cv::Vec4i> m_hierarchy{};
+  StageProfiler *m_profiler{nullptr};
+  ProcessingQuality m_quality{};
+  bool m_specialized{true};
+};
+
+#endif
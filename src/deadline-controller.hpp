@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DEADLINE_CONTROLLER_HPP
+#define DEADLINE_CONTROLLER_HPP
+
+#include "steering-detector.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Lowers the quality of the cone detection when frames take too long, e.g.
+// when other services compete for the CPU, and raises it again when there is
+// headroom. Each level adds a shortcut to the ones before it:
+//
+//   FULL             the detection as tuned
+//   HALF_RESOLUTION  segment the regions of interest at half the width and height
+//   NO_MORPHOLOGY    also skip blur, dilate and erode
+//   SKIP_FRAMES      also process only every other frame; the others repeat
+//                    the last steering wheel angle
+//
+// A frame over the budget, or STEP_DOWN_FRAMES frames in a row over
+// STEP_DOWN_SHARE of it, lower the level by one. STEP_UP_SHARE is low enough
+// that the next level up, which costs up to four times as much, still fits;
+// the level is raised after that many frames in a row below it. If the level
+// has to be lowered soon after it was raised, twice as many frames are
+// required before the next attempt, so a box at the edge of its capacity does
+// not switch back and forth.
+class DeadlineController {
+ public:
+  enum Level : uint32_t {
+    FULL = 0,
+    HALF_RESOLUTION,
+    NO_MORPHOLOGY,
+    SKIP_FRAMES,
+    NUMBER_OF_LEVELS,
+  };
+
+  static const char *name(Level level) noexcept {
+    static const char *NAMES[NUMBER_OF_LEVELS]{"full", "half resolution", "no morphology", "skip frames"};
+    return (level < NUMBER_OF_LEVELS) ? NAMES[level] : "?";
+  }
+
+  static constexpr double STEP_DOWN_SHARE{0.8};
+  static constexpr double STEP_UP_SHARE{0.2};
+  static constexpr uint32_t STEP_DOWN_FRAMES{2};
+  static constexpr uint32_t MIN_STEP_UP_FRAMES{60};
+  static constexpr uint32_t MAX_STEP_UP_FRAMES{1920};
+
+ public:
+  // budget: time a frame may take from its copy out of the shared memory to
+  // the output of its steering wheel angle.
+  explicit DeadlineController(std::chrono::microseconds budget) noexcept
+      : m_budget{budget} {}
+
+  Level level() const noexcept {
+    return m_level;
+  }
+
+  ProcessingQuality quality() const noexcept {
+    ProcessingQuality quality;
+    quality.halfResolution = (HALF_RESOLUTION <= m_level);
+    quality.morphology = (NO_MORPHOLOGY > m_level);
+    return quality;
+  }
+
+  // Call once per frame; false if the frame should not be processed.
+  bool process() noexcept {
+    m_frames[m_level]++;
+    m_skipNext = (SKIP_FRAMES == m_level) && !m_skipNext;
+    return !m_skipNext;
+  }
+
+  // Time of a processed frame; true if the level changed.
+  bool update(std::chrono::nanoseconds duration) noexcept {
+    m_framesSinceChange++;
+    const double share{static_cast<double>(duration.count()) / static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(m_budget).count())};
+    m_slowFrames = (STEP_DOWN_SHARE < share) ? m_slowFrames + 1 : 0;
+    m_fastFrames = (STEP_UP_SHARE > share) ? m_fastFrames + 1 : 0;
+    if ((SKIP_FRAMES > m_level) && ((1.0 <= share) || (STEP_DOWN_FRAMES <= m_slowFrames))) {
+      // Raised too early: wait longer before the next attempt
+      if (m_raised && (m_framesSinceChange < m_stepUpFrames)) {
+        m_stepUpFrames = (MAX_STEP_UP_FRAMES / 2 < m_stepUpFrames) ? MAX_STEP_UP_FRAMES : 2 * m_stepUpFrames;
+      }
+      change(static_cast<Level>(m_level + 1), false);
+      return true;
+    }
+    if ((FULL < m_level) && (m_stepUpFrames <= m_fastFrames)) {
+      change(static_cast<Level>(m_level - 1), true);
+      return true;
+    }
+    // A level that held for long after it was raised proves the box can afford it again
+    if (m_raised && (4 * m_stepUpFrames <= m_framesSinceChange)) {
+      m_stepUpFrames = MIN_STEP_UP_FRAMES;
+    }
+    return false;
+  }
+
+  // Level before the last change.
+  Level previousLevel() const noexcept {
+    return m_previousLevel;
+  }
+
+  uint64_t changes() const noexcept {
+    return m_changes;
+  }
+
+  // Frames seen at level, processed or not.
+  uint64_t frames(Level level) const noexcept {
+    return (level < NUMBER_OF_LEVELS) ? m_frames[level] : 0;
+  }
+
+  // Print the number of frames per level and the number of changes.
+  void report(std::ostream &out) const {
+    out << "level;frames" << std::endl;
+    for (uint32_t i{0}; i < NUMBER_OF_LEVELS; i++) {
+      out << name(static_cast<Level>(i)) << ";" << m_frames[i] << std::endl;
+    }
+    out << "changes;" << m_changes << std::endl;
+  }
+
+ private:
+  void change(Level level, bool raised) noexcept {
+    m_previousLevel = m_level;
+    m_level = level;
+    m_raised = raised;
+    m_changes++;
+    m_framesSinceChange = 0;
+    m_slowFrames = 0;
+    m_fastFrames = 0;
+    m_skipNext = false;
+  }
+
+ private:
+  std::chrono::microseconds m_budget;
+  Level m_level{FULL};
+  Level m_previousLevel{FULL};
+  bool m_raised{false};
+  bool m_skipNext{false};
+  uint32_t m_slowFrames{0};
+  uint32_t m_fastFrames{0};
+  uint32_t m_stepUpFrames{MIN_STEP_UP_FRAMES};
+  uint64_t m_framesSinceChange{0};
+  uint64_t m_changes{0};
+  uint64_t m_frames[NUMBER_OF_LEVELS]{};
+};
+
+#endif
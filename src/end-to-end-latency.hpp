@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef END_TO_END_LATENCY_HPP
+#define END_TO_END_LATENCY_HPP
+
+#include "latency-histogram.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <ostream>
+
+// Age of every frame from its sample time stamp until the steering wheel angle
+// computed from it is emitted, checked against the 150 ms requirement.
+//
+// The sample time stamp of a frame is wall time (cluon::time::now() is the
+// system clock) while durations inside the process are measured with the
+// monotonic clock, which does not jump when the wall time is adjusted. Both
+// clocks are read once when a frame is acquired; its age then is wall time
+// minus sample time stamp, and the later ages add the monotonic time since.
+//
+// When frames come from a replayed recording, their time stamps belong to the
+// recording and not to this host. This is assumed when the first frame is
+// older than MAX_PLAUSIBLE_AGE or from the future; ages are then measured
+// relative to the frame that arrived with the smallest delay, i.e. they are a
+// lower bound that still shows queueing and processing delays.
+class EndToEndLatency {
+ public:
+  static constexpr int64_t BUDGET_IN_MICROSECONDS{150 * 1000};
+  static constexpr int64_t MAX_PLAUSIBLE_AGE_IN_MICROSECONDS{10 * 1000 * 1000};
+
+  enum Checkpoint : uint32_t {
+    ACQUISITION = 0, // frame copied out of the shared memory
+    DECISION,        // steering wheel angle computed
+    EMISSION,        // steering wheel angle written
+    NUMBER_OF_CHECKPOINTS,
+  };
+
+ public:
+  explicit EndToEndLatency(std::chrono::seconds interval) noexcept
+      : m_interval{interval}
+      , m_lastReport{std::chrono::steady_clock::now()}
+      , m_acquired{} {}
+
+  // Start the next frame with the sample time stamp from the shared memory.
+  void acquired(int64_t sampleTimeStampInMicroseconds) noexcept {
+    // Pair the wall time with the middle of two monotonic readings around it
+    const auto before = std::chrono::steady_clock::now();
+    const auto wall = std::chrono::system_clock::now();
+    const auto after = std::chrono::steady_clock::now();
+    m_acquired = before + (after - before) / 2;
+
+    const int64_t wallInMicroseconds{std::chrono::duration_cast<std::chrono::microseconds>(wall.time_since_epoch()).count()};
+    const int64_t offset{wallInMicroseconds - sampleTimeStampInMicroseconds};
+    if (0 == m_frames + m_intervalFrames) {
+      m_recordingClock = (0 > offset) || (MAX_PLAUSIBLE_AGE_IN_MICROSECONDS < offset);
+    }
+    if (m_recordingClock) {
+      m_smallestOffset = std::min(m_smallestOffset, offset);
+      m_ageAtAcquisition = offset - m_smallestOffset;
+    } else if (0 > offset) {
+      // A frame from the future: the wall time was set back or the clocks of
+      // the producer and this process differ
+      m_clockAnomalies++;
+      m_ageAtAcquisition = 0;
+    } else {
+      m_ageAtAcquisition = offset;
+    }
+    record(ACQUISITION, m_ageAtAcquisition);
+  }
+
+  void decided() noexcept {
+    record(DECISION, ageNow());
+  }
+
+  // Finish the frame; returns false if it took longer than the budget.
+  bool emitted() noexcept {
+    const int64_t age{ageNow()};
+    record(EMISSION, age);
+    const int64_t processingTime{age - m_ageAtAcquisition};
+    m_processingTimes.record(static_cast<uint64_t>(processingTime) * 1000);
+    m_intervalProcessingViolations += (BUDGET_IN_MICROSECONDS < processingTime) ? 1 : 0;
+    m_intervalFrames++;
+    return BUDGET_IN_MICROSECONDS >= age;
+  }
+
+  // Total number of frames and of frames older than the budget when emitted.
+  uint64_t frames() const noexcept {
+    return m_frames + m_intervalFrames;
+  }
+
+  uint64_t violations() const noexcept {
+    return m_violations[EMISSION] + m_intervalViolations[EMISSION];
+  }
+
+  // Print the ages per checkpoint if the interval has passed since the last
+  // report, and start the next interval.
+  void reportIfDue(std::ostream &out) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastReport >= m_interval) {
+      m_lastReport = now;
+      report(out);
+    }
+  }
+
+  void report(std::ostream &out) {
+    static const char *NAMES[NUMBER_OF_CHECKPOINTS]{"age at acquisition", "age at decision", "age at emission"};
+    out << "latency;count;p50_ms;p90_ms;p99_ms;max_ms;over_150_ms;over_150_ms_total" << std::endl;
+    for (uint32_t i{0}; i < NUMBER_OF_CHECKPOINTS; i++) {
+      out << NAMES[i] << ";" << m_ages[i].count();
+      writePercentilesInMilliseconds(out, m_ages[i]);
+      m_violations[i] += m_intervalViolations[i];
+      out << ";" << m_intervalViolations[i] << ";" << m_violations[i] << std::endl;
+      m_ages[i].reset();
+      m_intervalViolations[i] = 0;
+    }
+    out << "processing;" << m_processingTimes.count();
+    writePercentilesInMilliseconds(out, m_processingTimes);
+    m_processingViolations += m_intervalProcessingViolations;
+    out << ";" << m_intervalProcessingViolations << ";" << m_processingViolations << std::endl;
+    m_processingTimes.reset();
+    m_intervalProcessingViolations = 0;
+    m_frames += m_intervalFrames;
+    m_intervalFrames = 0;
+
+    if (m_recordingClock) {
+      out << "latency: frame time stamps are not from this host's clock; ages are relative to the fastest frame" << std::endl;
+    }
+    if (0 < m_clockAnomalies) {
+      out << "latency: " << m_clockAnomalies << " frames had a time stamp in the future" << std::endl;
+    }
+  }
+
+ private:
+  int64_t ageNow() const noexcept {
+    const auto sinceAcquisition = std::chrono::steady_clock::now() - m_acquired;
+    return m_ageAtAcquisition + std::chrono::duration_cast<std::chrono::microseconds>(sinceAcquisition).count();
+  }
+
+  void record(Checkpoint checkpoint, int64_t ageInMicroseconds) noexcept {
+    m_ages[checkpoint].record(static_cast<uint64_t>(ageInMicroseconds) * 1000);
+    m_intervalViolations[checkpoint] += (BUDGET_IN_MICROSECONDS < ageInMicroseconds) ? 1 : 0;
+  }
+
+ private:
+  std::chrono::steady_clock::duration m_interval;
+  std::chrono::steady_clock::time_point m_lastReport;
+
+  std::chrono::steady_clock::time_point m_acquired;
+  int64_t m_ageAtAcquisition{0};
+
+  bool m_recordingClock{false};
+  int64_t m_smallestOffset{std::numeric_limits<int64_t>::max()};
+  uint64_t m_clockAnomalies{0};
+
+  LatencyHistogram m_ages[NUMBER_OF_CHECKPOINTS]{};
+  LatencyHistogram m_processingTimes{};
+  uint64_t m_intervalViolations[NUMBER_OF_CHECKPOINTS] = {};
+  uint64_t m_violations[NUMBER_OF_CHECKPOINTS] = {};
+  uint64_t m_intervalProcessingViolations{0};
+  uint64_t m_processingViolations{0};
+  uint64_t m_intervalFrames{0};
+  uint64_t m_frames{0};
+};
+
+#endif
@@ -0,0 +1,487 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FEATURE_CACHE_HPP
+#define FEATURE_CACHE_HPP
+
+#include "steering-detector.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// A blob found by the cone segmentation; coordinates are relative to the
+// region of interest of its channel.
+struct Blob {
+  double area;
+  float centroidX;
+  float centroidY;
+  int32_t x;
+  int32_t y;
+  int32_t width;
+  int32_t height;
+};
+
+// Everything the SteeringController needs from a frame, plus what is needed
+// to score its result.
+struct FrameFeatures {
+  int64_t sampleTimeStamp{0};
+  uint64_t frameHash{0};
+  float groundSteering{0.0f};
+  bool scored{false}; // false before the first GroundSteeringRequest
+  std::vector<Blob> blobs[NUMBER_OF_CONE_CHANNELS];
+};
+
+// 64 bit FNV-1a.
+class Fnv1a {
+ public:
+  void add(const void *data, std::size_t size) noexcept {
+    const unsigned char *bytes{static_cast<const unsigned char *>(data)};
+    for (std::size_t i{0}; i < size; i++) {
+      m_hash = (m_hash ^ bytes[i]) * 0x100000001b3ULL;
+    }
+  }
+
+  uint64_t value() const noexcept {
+    return m_hash;
+  }
+
+ private:
+  uint64_t m_hash{0xcbf29ce484222325ULL};
+};
+
+// Identifies the perception parameters; features cached with another key
+// were computed with different HSV ranges or regions of interest, by another
+// version of the cone segmentation, or in another quality.
+inline uint64_t perceptionKey(const SteeringDetectorConfig &config) noexcept {
+  Fnv1a hash;
+  // FeatureExtractor runs the full detection
+  const ProcessingQuality quality{};
+  const uint32_t segmentation[]{ConeSegmentation::OUTPUT_VERSION, quality.halfResolution ? 1u : 0u, quality.morphology ? 1u : 0u};
+  hash.add(segmentation, sizeof(segmentation));
+  for (const HsvRange *range : {&config.blue, &config.yellow}) {
+    const int values[]{range->minHue, range->maxHue, range->minSat, range->maxSat, range->minValue, range->maxValue};
+    hash.add(values, sizeof(values));
+  }
+  for (const cv::Rect *roi : {&config.regionOfInterestRight, &config.regionOfInterestCentre}) {
+    const int values[]{roi->x, roi->y, roi->width, roi->height};
+    hash.add(values, sizeof(values));
+  }
+  return hash.value();
+}
+
+// Identifies the pixels of a frame region.
+inline uint64_t frameHash(const cv::Mat &region) noexcept {
+  Fnv1a hash;
+  const std::size_t rowSize{static_cast<std::size_t>(region.cols) * region.elemSize()};
+  for (int row{0}; row < region.rows; row++) {
+    hash.add(region.ptr(row), rowSize);
+  }
+  return hash.value();
+}
+
+// Size and modification time in ns of the recording and of its .frames file
+// that the features were computed from; a cache whose recording was replaced
+// since, even under the same name, does not match.
+struct FeatureSource {
+  uint64_t recordingSize{0};
+  int64_t recordingModificationTime{0};
+  uint64_t framesSize{0}; // 0 if there is no .frames file
+  int64_t framesModificationTime{0};
+
+  static FeatureSource of(const std::string &recFile, const std::string &framesFile) noexcept {
+    FeatureSource source;
+    statusOf(recFile, source.recordingSize, source.recordingModificationTime);
+    statusOf(framesFile, source.framesSize, source.framesModificationTime);
+    return source;
+  }
+
+  bool operator==(const FeatureSource &other) const noexcept {
+    return (recordingSize == other.recordingSize) && (recordingModificationTime == other.recordingModificationTime) && (framesSize == other.framesSize) &&
+           (framesModificationTime == other.framesModificationTime);
+  }
+
+  bool operator!=(const FeatureSource &other) const noexcept {
+    return !(*this == other);
+  }
+
+ private:
+  static void statusOf(const std::string &file, uint64_t &size, int64_t &modificationTime) noexcept {
+    struct stat fileStatus;
+    if (0 == ::stat(file.c_str(), &fileStatus)) {
+      size = static_cast<uint64_t>(fileStatus.st_size);
+      modificationTime = static_cast<int64_t>(fileStatus.st_mtim.tv_sec) * 1000 * 1000 * 1000 + static_cast<int64_t>(fileStatus.st_mtim.tv_nsec);
+    }
+  }
+};
+
+// Runs the cone segmentation of all channels on every frame, independent of
+// which channels the controller would look at, so that any controller
+// configuration can be replayed from the result.
+class FeatureExtractor {
+ public:
+  explicit FeatureExtractor(const SteeringDetectorConfig &config = SteeringDetectorConfig{}) noexcept
+      : m_config{config} {}
+
+  // Fill the blobs of features from a frame (BGR or BGRA, or HSV if imgIsHsv).
+  void extract(const cv::Mat &img, bool imgIsHsv, FrameFeatures &features) {
+    for (uint32_t channel{0}; channel < NUMBER_OF_CONE_CHANNELS; channel++) {
+      const bool right{YELLOW_RIGHT == channel};
+      const auto &found = m_segmentation.detect(img(right ? m_config.regionOfInterestRight : m_config.regionOfInterestCentre),
+                                                (BLUE_CENTRE == channel) ? m_config.blue : m_config.yellow, imgIsHsv);
+      std::vector<Blob> &blobs{features.blobs[channel]};
+      blobs.clear();
+      for (const auto &contour : found) {
+        const cv::Moments moments{cv::moments(contour)};
+        const cv::Rect bbox{cv::boundingRect(contour)};
+        const bool hasArea{0.0 < moments.m00};
+        blobs.push_back(Blob{cv::contourArea(contour),
+                             hasArea ? static_cast<float>(moments.m10 / moments.m00) : static_cast<float>(bbox.x),
+                             hasArea ? static_cast<float>(moments.m01 / moments.m00) : static_cast<float>(bbox.y),
+                             bbox.x, bbox.y, bbox.width, bbox.height});
+      }
+    }
+  }
+
+ private:
+  SteeringDetectorConfig m_config;
+  ConeSegmentation m_segmentation{};
+};
+
+// Memory-mapped, columnar file of FrameFeatures.
+//
+// Layout (native byte order, checked by a byte order mark):
+//   header   "STEERFTR", version, byte order mark, perception key, number of
+//            frames N, number of blobs M, offsets of the columns below,
+//            FeatureSource of the recording
+//   frames   sample time stamps (N x int64), frame hashes (N x uint64),
+//            ground steering (N x float), scored (N x uint8)
+//   blobs    index of the first blob per frame and channel (3N+1 x uint64),
+//            then area (M x double), centroid x, centroid y (M x float),
+//            bounding box x, y, width, height (M x int32)
+// Every column starts at a multiple of 8 bytes. A controller reads only the
+// blob offsets and areas, which are contiguous.
+class FeatureCache {
+ public:
+  enum : uint32_t {
+    VERSION = 2,
+    BYTE_ORDER_MARK = 0x01020304,
+    HEADER_SIZE = 256,
+  };
+
+  static constexpr const char *MAGIC{"STEERFTR"};
+  static constexpr std::size_t MAGIC_SIZE{8};
+
+  enum Column : uint32_t {
+    SAMPLE_TIME_STAMPS = 0,
+    FRAME_HASHES,
+    GROUND_STEERING,
+    SCORED,
+    BLOB_OFFSETS,
+    AREAS,
+    CENTROIDS_X,
+    CENTROIDS_Y,
+    BBOXES_X,
+    BBOXES_Y,
+    BBOXES_WIDTH,
+    BBOXES_HEIGHT,
+    NUMBER_OF_COLUMNS,
+  };
+
+  // Offsets into the header.
+  enum : std::size_t {
+    OFFSET_VERSION = 8,
+    OFFSET_BYTE_ORDER_MARK = 12,
+    OFFSET_PERCEPTION_KEY = 16,
+    OFFSET_NUMBER_OF_FRAMES = 24,
+    OFFSET_NUMBER_OF_BLOBS = 32,
+    OFFSET_COLUMNS = 40,
+    OFFSET_SOURCE = 136,
+  };
+
+  // Return <recording>.features for the given recording.
+  static std::string featuresFileFor(const std::string &recFile) {
+    return recFile + ".features";
+  }
+};
+
+static_assert(FeatureCache::OFFSET_SOURCE + sizeof(FeatureSource) <= FeatureCache::HEADER_SIZE, "The header must hold the source of the features");
+
+// Collects FrameFeatures and writes them as a FeatureCache file.
+class FeatureCacheWriter {
+ public:
+  void add(const FrameFeatures &features) {
+    m_sampleTimeStamps.push_back(features.sampleTimeStamp);
+    m_frameHashes.push_back(features.frameHash);
+    m_groundSteering.push_back(features.groundSteering);
+    m_scored.push_back(features.scored ? 1 : 0);
+    for (uint32_t channel{0}; channel < NUMBER_OF_CONE_CHANNELS; channel++) {
+      for (const Blob &blob : features.blobs[channel]) {
+        m_areas.push_back(blob.area);
+        m_centroidsX.push_back(blob.centroidX);
+        m_centroidsY.push_back(blob.centroidY);
+        m_bboxesX.push_back(blob.x);
+        m_bboxesY.push_back(blob.y);
+        m_bboxesWidth.push_back(blob.width);
+        m_bboxesHeight.push_back(blob.height);
+      }
+      m_blobOffsets.push_back(m_areas.size());
+    }
+  }
+
+  std::size_t size() const noexcept {
+    return m_sampleTimeStamps.size();
+  }
+
+  // Write all features added so far; the file is replaced atomically.
+  bool write(const std::string &file, uint64_t perceptionKey, const FeatureSource &source) const {
+    const std::string tmpFile{file + ".tmp"};
+    bool retVal{false};
+    {
+      std::ofstream out(tmpFile, std::ios::out | std::ios::binary | std::ios::trunc);
+      uint64_t offsets[FeatureCache::NUMBER_OF_COLUMNS];
+      uint64_t position{FeatureCache::HEADER_SIZE};
+      auto place = [&position, &offsets](FeatureCache::Column column, std::size_t size) {
+        offsets[column] = position;
+        position += (size + 7) & ~static_cast<std::size_t>(7);
+      };
+      place(FeatureCache::SAMPLE_TIME_STAMPS, bytesOf(m_sampleTimeStamps));
+      place(FeatureCache::FRAME_HASHES, bytesOf(m_frameHashes));
+      place(FeatureCache::GROUND_STEERING, bytesOf(m_groundSteering));
+      place(FeatureCache::SCORED, bytesOf(m_scored));
+      place(FeatureCache::BLOB_OFFSETS, bytesOf(m_blobOffsets));
+      place(FeatureCache::AREAS, bytesOf(m_areas));
+      place(FeatureCache::CENTROIDS_X, bytesOf(m_centroidsX));
+      place(FeatureCache::CENTROIDS_Y, bytesOf(m_centroidsY));
+      place(FeatureCache::BBOXES_X, bytesOf(m_bboxesX));
+      place(FeatureCache::BBOXES_Y, bytesOf(m_bboxesY));
+      place(FeatureCache::BBOXES_WIDTH, bytesOf(m_bboxesWidth));
+      place(FeatureCache::BBOXES_HEIGHT, bytesOf(m_bboxesHeight));
+
+      char header[FeatureCache::HEADER_SIZE] = {};
+      const uint32_t version{FeatureCache::VERSION};
+      const uint32_t byteOrderMark{FeatureCache::BYTE_ORDER_MARK};
+      const uint64_t numberOfFrames{m_sampleTimeStamps.size()};
+      const uint64_t numberOfBlobs{m_areas.size()};
+      std::memcpy(header, FeatureCache::MAGIC, FeatureCache::MAGIC_SIZE);
+      std::memcpy(header + FeatureCache::OFFSET_VERSION, &version, sizeof(version));
+      std::memcpy(header + FeatureCache::OFFSET_BYTE_ORDER_MARK, &byteOrderMark, sizeof(byteOrderMark));
+      std::memcpy(header + FeatureCache::OFFSET_PERCEPTION_KEY, &perceptionKey, sizeof(perceptionKey));
+      std::memcpy(header + FeatureCache::OFFSET_NUMBER_OF_FRAMES, &numberOfFrames, sizeof(numberOfFrames));
+      std::memcpy(header + FeatureCache::OFFSET_NUMBER_OF_BLOBS, &numberOfBlobs, sizeof(numberOfBlobs));
+      std::memcpy(header + FeatureCache::OFFSET_COLUMNS, offsets, sizeof(offsets));
+      std::memcpy(header + FeatureCache::OFFSET_SOURCE, &source, sizeof(source));
+      out.write(header, sizeof(header));
+
+      writeColumn(out, m_sampleTimeStamps);
+      writeColumn(out, m_frameHashes);
+      writeColumn(out, m_groundSteering);
+      writeColumn(out, m_scored);
+      writeColumn(out, m_blobOffsets);
+      writeColumn(out, m_areas);
+      writeColumn(out, m_centroidsX);
+      writeColumn(out, m_centroidsY);
+      writeColumn(out, m_bboxesX);
+      writeColumn(out, m_bboxesY);
+      writeColumn(out, m_bboxesWidth);
+      writeColumn(out, m_bboxesHeight);
+      out.flush();
+      retVal = out.good();
+    }
+    if (retVal) {
+      retVal = (0 == std::rename(tmpFile.c_str(), file.c_str()));
+    }
+    if (!retVal) {
+      std::remove(tmpFile.c_str());
+    }
+    return retVal;
+  }
+
+ private:
+  template <typename T>
+  static std::size_t bytesOf(const std::vector<T> &column) noexcept {
+    return column.size() * sizeof(T);
+  }
+
+  template <typename T>
+  static void writeColumn(std::ofstream &out, const std::vector<T> &column) {
+    const char padding[8] = {};
+    out.write(reinterpret_cast<const char *>(column.data()), static_cast<std::streamsize>(bytesOf(column)));
+    out.write(padding, static_cast<std::streamsize>(((bytesOf(column) + 7) & ~static_cast<std::size_t>(7)) - bytesOf(column)));
+  }
+
+ private:
+  std::vector<int64_t> m_sampleTimeStamps{};
+  std::vector<uint64_t> m_frameHashes{};
+  std::vector<float> m_groundSteering{};
+  std::vector<uint8_t> m_scored{};
+  std::vector<uint64_t> m_blobOffsets{0};
+  std::vector<double> m_areas{};
+  std::vector<float> m_centroidsX{};
+  std::vector<float> m_centroidsY{};
+  std::vector<int32_t> m_bboxesX{};
+  std::vector<int32_t> m_bboxesY{};
+  std::vector<int32_t> m_bboxesWidth{};
+  std::vector<int32_t> m_bboxesHeight{};
+};
+
+// Read-only view on a FeatureCache file.
+class FeatureCacheReader {
+ public:
+  explicit FeatureCacheReader(const std::string &file) noexcept {
+    const int fd{::open(file.c_str(), O_RDONLY)};
+    if (0 > fd) {
+      return;
+    }
+    struct stat fileStatus;
+    if ((0 == ::fstat(fd, &fileStatus)) && (static_cast<off_t>(FeatureCache::HEADER_SIZE) <= fileStatus.st_size)) {
+      const std::size_t size{static_cast<std::size_t>(fileStatus.st_size)};
+      void *mapped{::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)};
+      if (MAP_FAILED != mapped) {
+        m_mapped = static_cast<const char *>(mapped);
+        m_mappedSize = size;
+        if (!readHeader()) {
+          ::munmap(const_cast<char *>(m_mapped), m_mappedSize);
+          m_mapped = nullptr;
+          m_mappedSize = 0;
+        }
+      }
+    }
+    ::close(fd);
+  }
+
+  ~FeatureCacheReader() {
+    if (nullptr != m_mapped) {
+      ::munmap(const_cast<char *>(m_mapped), m_mappedSize);
+    }
+  }
+
+  FeatureCacheReader(const FeatureCacheReader &) = delete;
+  FeatureCacheReader &operator=(const FeatureCacheReader &) = delete;
+
+  bool valid() const noexcept {
+    return nullptr != m_mapped;
+  }
+
+  uint64_t perceptionKey() const noexcept {
+    return m_perceptionKey;
+  }
+
+  const FeatureSource &source() const noexcept {
+    return m_source;
+  }
+
+  std::size_t size() const noexcept {
+    return m_numberOfFrames;
+  }
+
+  int64_t sampleTimeStamp(std::size_t i) const noexcept {
+    return column<int64_t>(FeatureCache::SAMPLE_TIME_STAMPS)[i];
+  }
+
+  uint64_t frameHash(std::size_t i) const noexcept {
+    return column<uint64_t>(FeatureCache::FRAME_HASHES)[i];
+  }
+
+  float groundSteering(std::size_t i) const noexcept {
+    return column<float>(FeatureCache::GROUND_STEERING)[i];
+  }
+
+  bool scored(std::size_t i) const noexcept {
+    return 0 != column<uint8_t>(FeatureCache::SCORED)[i];
+  }
+
+  // Areas of the blobs of frame i in the given channel, for the SteeringController.
+  BlobAreas areas(std::size_t i, ConeChannel channel) const noexcept {
+    const uint64_t *offsets{column<uint64_t>(FeatureCache::BLOB_OFFSETS) + i * NUMBER_OF_CONE_CHANNELS + channel};
+    const double *areas{column<double>(FeatureCache::AREAS)};
+    return BlobAreas{areas + offsets[0], areas + offsets[1]};
+  }
+
+  // Complete blobs of frame i in the given channel.
+  std::vector<Blob> blobs(std::size_t i, ConeChannel channel) const {
+    const uint64_t *offsets{column<uint64_t>(FeatureCache::BLOB_OFFSETS) + i * NUMBER_OF_CONE_CHANNELS + channel};
+    std::vector<Blob> retVal;
+    for (uint64_t j{offsets[0]}; j < offsets[1]; j++) {
+      retVal.push_back(Blob{column<double>(FeatureCache::AREAS)[j],
+                            column<float>(FeatureCache::CENTROIDS_X)[j],
+                            column<float>(FeatureCache::CENTROIDS_Y)[j],
+                            column<int32_t>(FeatureCache::BBOXES_X)[j],
+                            column<int32_t>(FeatureCache::BBOXES_Y)[j],
+                            column<int32_t>(FeatureCache::BBOXES_WIDTH)[j],
+                            column<int32_t>(FeatureCache::BBOXES_HEIGHT)[j]});
+    }
+    return retVal;
+  }
+
+ private:
+  bool readHeader() noexcept {
+    uint32_t version{0};
+    uint32_t byteOrderMark{0};
+    uint64_t numberOfFrames{0};
+    uint64_t numberOfBlobs{0};
+    std::memcpy(&version, m_mapped + FeatureCache::OFFSET_VERSION, sizeof(version));
+    std::memcpy(&byteOrderMark, m_mapped + FeatureCache::OFFSET_BYTE_ORDER_MARK, sizeof(byteOrderMark));
+    std::memcpy(&m_perceptionKey, m_mapped + FeatureCache::OFFSET_PERCEPTION_KEY, sizeof(m_perceptionKey));
+    std::memcpy(&numberOfFrames, m_mapped + FeatureCache::OFFSET_NUMBER_OF_FRAMES, sizeof(numberOfFrames));
+    std::memcpy(&numberOfBlobs, m_mapped + FeatureCache::OFFSET_NUMBER_OF_BLOBS, sizeof(numberOfBlobs));
+    std::memcpy(m_offsets, m_mapped + FeatureCache::OFFSET_COLUMNS, sizeof(m_offsets));
+    std::memcpy(&m_source, m_mapped + FeatureCache::OFFSET_SOURCE, sizeof(m_source));
+    if ((0 != std::memcmp(m_mapped, FeatureCache::MAGIC, FeatureCache::MAGIC_SIZE)) || (FeatureCache::VERSION != version) ||
+        (FeatureCache::BYTE_ORDER_MARK != byteOrderMark)) {
+      return false;
+    }
+
+    // Every column must lie within the file and be aligned for its type.
+    const uint64_t sizes[FeatureCache::NUMBER_OF_COLUMNS]{
+        numberOfFrames * sizeof(int64_t), numberOfFrames * sizeof(uint64_t), numberOfFrames * sizeof(float), numberOfFrames * sizeof(uint8_t),
+        (numberOfFrames * NUMBER_OF_CONE_CHANNELS + 1) * sizeof(uint64_t), numberOfBlobs * sizeof(double), numberOfBlobs * sizeof(float),
+        numberOfBlobs * sizeof(float), numberOfBlobs * sizeof(int32_t), numberOfBlobs * sizeof(int32_t), numberOfBlobs * sizeof(int32_t),
+        numberOfBlobs * sizeof(int32_t)};
+    for (uint32_t c{0}; c < FeatureCache::NUMBER_OF_COLUMNS; c++) {
+      if ((0 != (m_offsets[c] % 8)) || (m_offsets[c] > m_mappedSize) || (sizes[c] > m_mappedSize - m_offsets[c])) {
+        return false;
+      }
+    }
+    m_numberOfFrames = static_cast<std::size_t>(numberOfFrames);
+    return column<uint64_t>(FeatureCache::BLOB_OFFSETS)[numberOfFrames * NUMBER_OF_CONE_CHANNELS] == numberOfBlobs;
+  }
+
+  template <typename T>
+  const T *column(FeatureCache::Column c) const noexcept {
+    return reinterpret_cast<const T *>(m_mapped + m_offsets[c]);
+  }
+
+ private:
+  const char *m_mapped{nullptr};
+  std::size_t m_mappedSize{0};
+
+  uint64_t m_perceptionKey{0};
+  FeatureSource m_source{};
+  std::size_t m_numberOfFrames{0};
+  uint64_t m_offsets[FeatureCache::NUMBER_OF_COLUMNS]{};
+};
+
+#endif
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Include the single-file, header-only middleware libcluon to create high-performance microservices
+#include "cluon-complete.hpp"
+
+#include "cluon-complete.cpp"
+
+// Include the container for raw frames and the regions the cone detection looks at
+#include "frame-recording.hpp"
+#include "steering-detector.hpp"
+
+#include <iostream>
+
+int32_t main(int32_t argc, char ** argv) {
+  int32_t retCode {
+    1
+  };
+  auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  if ((0 == commandlineArguments.count("name")) ||
+    (0 == commandlineArguments.count("width")) ||
+    (0 == commandlineArguments.count("height")) ||
+    (0 == commandlineArguments.count("out"))) {
+    std::cerr << argv[0] << " records the frames from a shared memory area containing an ARGB image." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --name=<name of shared memory area> --width=<width> --height=<height> --out=<file> [--roi] [--frames=<n>]" << std::endl;
+    std::cerr << "         --name:   name of the shared memory area to attach" << std::endl;
+    std::cerr << "         --width:  width of the frame" << std::endl;
+    std::cerr << "         --height: height of the frame" << std::endl;
+    std::cerr << "         --out:    file to write the frames to" << std::endl;
+    std::cerr << "         --roi:    only store the part of the frames that the cone detection looks at" << std::endl;
+    std::cerr << "         --frames: stop after this many frames; default: until killed" << std::endl;
+    std::cerr << "Example: " << argv[0] << " --name=img --width=640 --height=480 --out=track.frames --roi" << std::endl;
+  } else {
+    const std::string NAME {
+      commandlineArguments["name"]
+    };
+    const uint32_t WIDTH {
+      static_cast < uint32_t > (std::stoi(commandlineArguments["width"]))
+    };
+    const uint32_t HEIGHT {
+      static_cast < uint32_t > (std::stoi(commandlineArguments["height"]))
+    };
+    const uint64_t FRAMES {
+      (0 != commandlineArguments.count("frames")) ? static_cast < uint64_t > (std::stoull(commandlineArguments["frames"])) : 0
+    };
+    constexpr uint32_t BYTES_PER_PIXEL {
+      4
+    };
+
+    // Either the whole frame or the bounding box of the regions of interest of the cone detection.
+    FrameRegion region {
+      0, 0, WIDTH, HEIGHT
+    };
+    if (0 != commandlineArguments.count("roi")) {
+      const cv::Rect roi {
+        SteeringDetectorConfig {}.boundingRegionOfInterest()
+      };
+      region.x = static_cast < uint32_t > (roi.x);
+      region.y = static_cast < uint32_t > (roi.y);
+      region.width = static_cast < uint32_t > (roi.width);
+      region.height = static_cast < uint32_t > (roi.height);
+    }
+
+    std::unique_ptr < cluon::SharedMemory > sharedMemory {
+      new cluon::SharedMemory {
+        NAME
+      }
+    };
+    if (!sharedMemory || !sharedMemory -> valid()) {
+      std::cerr << argv[0] << ": Failed to attach to shared memory '" << NAME << "'." << std::endl;
+    } else if (sharedMemory -> size() < static_cast < uint64_t > (WIDTH) * HEIGHT * BYTES_PER_PIXEL) {
+      std::cerr << argv[0] << ": Shared memory '" << NAME << "' is too small for " << WIDTH << "x" << HEIGHT << " pixels." << std::endl;
+    } else {
+      FrameRecordingWriter writer(commandlineArguments["out"], WIDTH, HEIGHT, BYTES_PER_PIXEL, region);
+      if (!writer.valid()) {
+        std::cerr << argv[0] << ": Failed to create '" << commandlineArguments["out"] << "'." << std::endl;
+      } else {
+        std::clog << argv[0] << ": Recording " << region.width << "x" << region.height << "+" << region.x << "+" << region.y << " of '" << sharedMemory -> name() << "'." << std::endl;
+
+        // Every frame is complete on disk right after append(); killing the capture loses nothing.
+        while ((0 == FRAMES) || (writer.numberOfFrames() < FRAMES)) {
+          sharedMemory -> wait();
+
+          sharedMemory -> lock();
+          const int64_t sMicro {
+            cluon::time::toMicroseconds(sharedMemory -> getTimeStamp().second)
+          };
+          const bool appended {
+            writer.append(sharedMemory -> data(), sMicro)
+          };
+          sharedMemory -> unlock();
+
+          if (!appended) {
+            std::cerr << argv[0] << ": Failed to write frame " << writer.numberOfFrames() << "." << std::endl;
+            break;
+          }
+        }
+        std::clog << argv[0] << ": Recorded " << writer.numberOfFrames() << " frames." << std::endl;
+        retCode = 0;
+      }
+    }
+  }
+  return retCode;
+}
@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAME_RECORDING_HPP
+#define FRAME_RECORDING_HPP
+
+#include <endian.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Rectangle of a frame in pixels.
+struct FrameRegion {
+  uint32_t x;
+  uint32_t y;
+  uint32_t width;
+  uint32_t height;
+};
+
+// Container for raw frames grabbed from shared memory; only the pixels of a
+// fixed region of every frame are stored.
+//
+// Layout (all numbers little endian):
+//   header    "FRAMEREC", version, width, height, bytes per pixel, region
+//             (x, y, width, height), number of frames, reserved; 64 bytes
+//   frame i   sample time stamp in microseconds (8 bytes) followed by the rows
+//             of the region, padded to a multiple of 8 bytes
+//
+// All frames have the same size, so the fixed stride is the index: frame i
+// starts at HEADER_SIZE + i * stride, and the monotonic time stamps allow a
+// binary search by time. The writer appends into a memory mapping and bumps
+// the number of frames after each complete frame; a capture that is killed
+// leaves a readable file.
+class FrameRecording {
+ public:
+  enum : uint32_t {
+    VERSION = 1,
+    HEADER_SIZE = 64,
+    TIMESTAMP_SIZE = 8,
+  };
+
+  static constexpr const char *MAGIC{"FRAMEREC"};
+  static constexpr std::size_t MAGIC_SIZE{8};
+
+  // Offsets into the header.
+  enum : std::size_t {
+    OFFSET_VERSION = 8,
+    OFFSET_WIDTH = 12,
+    OFFSET_HEIGHT = 16,
+    OFFSET_BYTES_PER_PIXEL = 20,
+    OFFSET_REGION = 24,
+    OFFSET_NUMBER_OF_FRAMES = 40,
+  };
+
+  // Number of bytes from the start of one frame to the next.
+  static uint64_t strideFor(const FrameRegion &region, uint32_t bytesPerPixel) noexcept {
+    const uint64_t size{TIMESTAMP_SIZE + static_cast<uint64_t>(region.width) * region.height * bytesPerPixel};
+    return (size + 7) & ~static_cast<uint64_t>(7);
+  }
+
+  // Check that region lies within a frame of the given size and is not empty.
+  static bool fits(const FrameRegion &region, uint32_t width, uint32_t height) noexcept {
+    return (0 < region.width) && (0 < region.height) && (region.x < width) && (region.y < height) && (region.width <= width - region.x) &&
+           (region.height <= height - region.y);
+  }
+};
+
+// Appends frames to a FrameRecording file.
+class FrameRecordingWriter {
+ private:
+  // The file grows in steps of at least this size to keep remapping rare.
+  static constexpr uint64_t GROWTH_IN_BYTES{64 * 1024 * 1024};
+
+ public:
+  FrameRecordingWriter(const std::string &file, uint32_t width, uint32_t height, uint32_t bytesPerPixel, const FrameRegion &region) noexcept
+      : m_width{width}
+      , m_height{height}
+      , m_bytesPerPixel{bytesPerPixel}
+      , m_region(region)
+      , m_stride{FrameRecording::strideFor(region, bytesPerPixel)} {
+    if ((0 == bytesPerPixel) || !FrameRecording::fits(region, width, height)) {
+      return;
+    }
+    m_fd = ::open(file.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if ((0 <= m_fd) && reserve(FrameRecording::HEADER_SIZE + m_stride)) {
+      std::memcpy(m_mapped, FrameRecording::MAGIC, FrameRecording::MAGIC_SIZE);
+      put32(FrameRecording::OFFSET_VERSION, FrameRecording::VERSION);
+      put32(FrameRecording::OFFSET_WIDTH, width);
+      put32(FrameRecording::OFFSET_HEIGHT, height);
+      put32(FrameRecording::OFFSET_BYTES_PER_PIXEL, bytesPerPixel);
+      put32(FrameRecording::OFFSET_REGION + 0, region.x);
+      put32(FrameRecording::OFFSET_REGION + 4, region.y);
+      put32(FrameRecording::OFFSET_REGION + 8, region.width);
+      put32(FrameRecording::OFFSET_REGION + 12, region.height);
+      put64(FrameRecording::OFFSET_NUMBER_OF_FRAMES, 0);
+    }
+  }
+
+  ~FrameRecordingWriter() {
+    if (nullptr != m_mapped) {
+      ::munmap(m_mapped, m_mappedSize);
+    }
+    if (0 <= m_fd) {
+      // Drop the preallocated tail.
+      if (0 != ::ftruncate(m_fd, static_cast<off_t>(FrameRecording::HEADER_SIZE + m_numberOfFrames * m_stride))) {
+        // The reader ignores a tail beyond the number of frames.
+      }
+      ::close(m_fd);
+    }
+  }
+
+  FrameRecordingWriter(const FrameRecordingWriter &) = delete;
+  FrameRecordingWriter &operator=(const FrameRecordingWriter &) = delete;
+
+  bool valid() const noexcept {
+    return nullptr != m_mapped;
+  }
+
+  // Append the region of a complete frame (width x height x bytesPerPixel bytes).
+  bool append(const char *frame, int64_t sampleTimeStamp) noexcept {
+    const uint64_t offset{FrameRecording::HEADER_SIZE + m_numberOfFrames * m_stride};
+    if (!valid() || (nullptr == frame) || !reserve(offset + m_stride)) {
+      return false;
+    }
+    put64(offset, static_cast<uint64_t>(sampleTimeStamp));
+
+    const std::size_t frameRowSize{static_cast<std::size_t>(m_width) * m_bytesPerPixel};
+    const std::size_t regionRowSize{static_cast<std::size_t>(m_region.width) * m_bytesPerPixel};
+    const char *src{frame + m_region.y * frameRowSize + m_region.x * m_bytesPerPixel};
+    char *dst{m_mapped + offset + FrameRecording::TIMESTAMP_SIZE};
+    for (uint32_t row{0}; row < m_region.height; row++) {
+      std::memcpy(dst, src, regionRowSize);
+      src += frameRowSize;
+      dst += regionRowSize;
+    }
+
+    // Publish the frame only after all of its bytes were written.
+    std::atomic_thread_fence(std::memory_order_release);
+    m_numberOfFrames++;
+    put64(FrameRecording::OFFSET_NUMBER_OF_FRAMES, m_numberOfFrames);
+    return true;
+  }
+
+  uint64_t numberOfFrames() const noexcept {
+    return m_numberOfFrames;
+  }
+
+ private:
+  // Make sure that the first size bytes of the file are mapped.
+  bool reserve(uint64_t size) noexcept {
+    if (size <= m_mappedSize) {
+      return true;
+    }
+    const uint64_t newSize{size + GROWTH_IN_BYTES};
+    if (0 != ::ftruncate(m_fd, static_cast<off_t>(newSize))) {
+      return false;
+    }
+    if (nullptr != m_mapped) {
+      ::munmap(m_mapped, m_mappedSize);
+      m_mapped = nullptr;
+      m_mappedSize = 0;
+    }
+    void *mapped{::mmap(nullptr, newSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0)};
+    if (MAP_FAILED == mapped) {
+      return false;
+    }
+    m_mapped = static_cast<char *>(mapped);
+    m_mappedSize = newSize;
+    return true;
+  }
+
+  void put32(std::size_t offset, uint32_t value) noexcept {
+    const uint32_t le{htole32(value)};
+    std::memcpy(m_mapped + offset, &le, sizeof(le));
+  }
+
+  void put64(std::size_t offset, uint64_t value) noexcept {
+    const uint64_t le{htole64(value)};
+    std::memcpy(m_mapped + offset, &le, sizeof(le));
+  }
+
+ private:
+  uint32_t m_width;
+  uint32_t m_height;
+  uint32_t m_bytesPerPixel;
+  FrameRegion m_region;
+  uint64_t m_stride;
+
+  int m_fd{-1};
+  char *m_mapped{nullptr};
+  uint64_t m_mappedSize{0};
+  uint64_t m_numberOfFrames{0};
+};
+
+// Read-only view on a FrameRecording file.
+class FrameRecordingReader {
+ public:
+  explicit FrameRecordingReader(const std::string &file) noexcept {
+    const int fd{::open(file.c_str(), O_RDONLY)};
+    if (0 > fd) {
+      return;
+    }
+    struct stat fileStatus;
+    if ((0 == ::fstat(fd, &fileStatus)) && (static_cast<off_t>(FrameRecording::HEADER_SIZE) <= fileStatus.st_size)) {
+      const std::size_t size{static_cast<std::size_t>(fileStatus.st_size)};
+      void *mapped{::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0)};
+      if (MAP_FAILED != mapped) {
+        m_mapped = static_cast<const char *>(mapped);
+        m_mappedSize = size;
+        if (!readHeader()) {
+          ::munmap(const_cast<char *>(m_mapped), m_mappedSize);
+          m_mapped = nullptr;
+          m_mappedSize = 0;
+        } else {
+          ::madvise(const_cast<char *>(m_mapped), m_mappedSize, MADV_SEQUENTIAL);
+        }
+      }
+    }
+    ::close(fd);
+  }
+
+  ~FrameRecordingReader() {
+    if (nullptr != m_mapped) {
+      ::munmap(const_cast<char *>(m_mapped), m_mappedSize);
+    }
+  }
+
+  FrameRecordingReader(const FrameRecordingReader &) = delete;
+  FrameRecordingReader &operator=(const FrameRecordingReader &) = delete;
+
+  bool valid() const noexcept {
+    return nullptr != m_mapped;
+  }
+
+  uint32_t width() const noexcept {
+    return m_width;
+  }
+
+  uint32_t height() const noexcept {
+    return m_height;
+  }
+
+  uint32_t bytesPerPixel() const noexcept {
+    return m_bytesPerPixel;
+  }
+
+  const FrameRegion &region() const noexcept {
+    return m_region;
+  }
+
+  // Number of complete frames.
+  std::size_t size() const noexcept {
+    return m_numberOfFrames;
+  }
+
+  int64_t sampleTimeStamp(std::size_t i) const noexcept {
+    uint64_t le{0};
+    std::memcpy(&le, frameAt(i), sizeof(le));
+    return static_cast<int64_t>(le64toh(le));
+  }
+
+  // Rows of the stored region of frame i, without padding between rows.
+  const char *regionData(std::size_t i) const noexcept {
+    return frameAt(i) + FrameRecording::TIMESTAMP_SIZE;
+  }
+
+  // Index of the first frame that was not sampled before the given time stamp, or size().
+  std::size_t lowerBound(int64_t sampleTimeStamp) const noexcept {
+    std::size_t first{0};
+    std::size_t count{m_numberOfFrames};
+    while (0 < count) {
+      const std::size_t step{count / 2};
+      if (this->sampleTimeStamp(first + step) < sampleTimeStamp) {
+        first += step + 1;
+        count -= step + 1;
+      } else {
+        count = step;
+      }
+    }
+    return first;
+  }
+
+  // Copy the stored region of frame i into its place in a complete frame
+  // (width x height x bytesPerPixel bytes); pixels outside are not touched.
+  void copyFrameTo(std::size_t i, char *frame) const noexcept {
+    const std::size_t frameRowSize{static_cast<std::size_t>(m_width) * m_bytesPerPixel};
+    const std::size_t regionRowSize{static_cast<std::size_t>(m_region.width) * m_bytesPerPixel};
+    const char *src{regionData(i)};
+    char *dst{frame + m_region.y * frameRowSize + m_region.x * m_bytesPerPixel};
+    for (uint32_t row{0}; row < m_region.height; row++) {
+      std::memcpy(dst, src, regionRowSize);
+      src += regionRowSize;
+      dst += frameRowSize;
+    }
+  }
+
+ private:
+  bool readHeader() noexcept {
+    if (0 != std::memcmp(m_mapped, FrameRecording::MAGIC, FrameRecording::MAGIC_SIZE) || (FrameRecording::VERSION != get32(FrameRecording::OFFSET_VERSION))) {
+      return false;
+    }
+    m_width = get32(FrameRecording::OFFSET_WIDTH);
+    m_height = get32(FrameRecording::OFFSET_HEIGHT);
+    m_bytesPerPixel = get32(FrameRecording::OFFSET_BYTES_PER_PIXEL);
+    m_region.x = get32(FrameRecording::OFFSET_REGION + 0);
+    m_region.y = get32(FrameRecording::OFFSET_REGION + 4);
+    m_region.width = get32(FrameRecording::OFFSET_REGION + 8);
+    m_region.height = get32(FrameRecording::OFFSET_REGION + 12);
+    if ((0 == m_bytesPerPixel) || !FrameRecording::fits(m_region, m_width, m_height)) {
+      return false;
+    }
+    m_stride = FrameRecording::strideFor(m_region, m_bytesPerPixel);
+
+    // Trust the header only as far as the file holds complete frames.
+    uint64_t le{0};
+    std::memcpy(&le, m_mapped + FrameRecording::OFFSET_NUMBER_OF_FRAMES, sizeof(le));
+    const uint64_t available{(m_mappedSize - FrameRecording::HEADER_SIZE) / m_stride};
+    const uint64_t numberOfFrames{le64toh(le)};
+    m_numberOfFrames = static_cast<std::size_t>((numberOfFrames < available) ? numberOfFrames : available);
+    return true;
+  }
+
+  uint32_t get32(std::size_t offset) const noexcept {
+    uint32_t le{0};
+    std::memcpy(&le, m_mapped + offset, sizeof(le));
+    return le32toh(le);
+  }
+
+  const char *frameAt(std::size_t i) const noexcept {
+    return m_mapped + FrameRecording::HEADER_SIZE + i * m_stride;
+  }
+
+ private:
+  const char *m_mapped{nullptr};
+  std::size_t m_mappedSize{0};
+
+  uint32_t m_width{0};
+  uint32_t m_height{0};
+  uint32_t m_bytesPerPixel{0};
+  FrameRegion m_region{0, 0, 0, 0};
+  uint64_t m_stride{0};
+  std::size_t m_numberOfFrames{0};
+};
+
+#endif
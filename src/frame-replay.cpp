@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Include the single-file, header-only middleware libcluon to create high-performance microservices
+#include "cluon-complete.hpp"
+
+#include "cluon-complete.cpp"
+
+// Include the container for raw frames written by frame-capture
+#include "frame-recording.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+int32_t main(int32_t argc, char ** argv) {
+  int32_t retCode {
+    1
+  };
+  auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  if ((0 == commandlineArguments.count("rec")) ||
+    (0 == commandlineArguments.count("name"))) {
+    std::cerr << argv[0] << " publishes the frames recorded by frame-capture into a shared memory area." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --rec=<file> --name=<name of shared memory area> [--max-speed] [--loop]" << std::endl;
+    std::cerr << "         --rec:       file written by frame-capture" << std::endl;
+    std::cerr << "         --name:      name of the shared memory area to create" << std::endl;
+    std::cerr << "         --max-speed: do not wait between frames as recorded" << std::endl;
+    std::cerr << "         --loop:      start over at the end of the recording" << std::endl;
+    std::cerr << "Example: " << argv[0] << " --rec=track.frames --name=img" << std::endl;
+  } else {
+    const bool MAX_SPEED {
+      commandlineArguments.count("max-speed") != 0
+    };
+    const bool LOOP {
+      commandlineArguments.count("loop") != 0
+    };
+
+    FrameRecordingReader reader {
+      commandlineArguments["rec"]
+    };
+    if (!reader.valid() || (0 == reader.size())) {
+      std::cerr << argv[0] << ": '" << commandlineArguments["rec"] << "' contains no frames." << std::endl;
+    } else {
+      const uint32_t SIZE {
+        reader.width() * reader.height() * reader.bytesPerPixel()
+      };
+      std::unique_ptr < cluon::SharedMemory > sharedMemory {
+        new cluon::SharedMemory {
+          commandlineArguments["name"], SIZE
+        }
+      };
+      if (!sharedMemory || !sharedMemory -> valid()) {
+        std::cerr << argv[0] << ": Failed to create shared memory '" << commandlineArguments["name"] << "'." << std::endl;
+      } else {
+        std::clog << argv[0] << ": Publishing " << reader.size() << " frames of " << reader.width() << "x" << reader.height() << " to '" << sharedMemory -> name() << "'." << std::endl;
+
+        // Pixels outside of a recorded region stay black.
+        sharedMemory -> lock();
+        std::memset(sharedMemory -> data(), 0, SIZE);
+        sharedMemory -> unlock();
+
+        do {
+          const int64_t firstSampleTimeStamp {
+            reader.sampleTimeStamp(0)
+          };
+          const auto start = std::chrono::steady_clock::now();
+          for (std::size_t i = 0; i < reader.size(); i++) {
+            const int64_t sMicro {
+              reader.sampleTimeStamp(i)
+            };
+            if (!MAX_SPEED) {
+              std::this_thread::sleep_until(start + std::chrono::microseconds(sMicro - firstSampleTimeStamp));
+            }
+
+            sharedMemory -> lock();
+            reader.copyFrameTo(i, sharedMemory -> data());
+            sharedMemory -> setTimeStamp(cluon::time::fromMicroseconds(sMicro));
+            sharedMemory -> unlock();
+            sharedMemory -> notifyAll();
+          }
+        } while (LOOP);
+        retCode = 0;
+      }
+    }
+  }
+  return retCode;
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FRAME_SOURCE_HPP
+#define FRAME_SOURCE_HPP
+
+#include "cluon-complete.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Frames (BGRA) from a shared memory area written by the camera or the video
+// decoder.
+class SharedMemoryFrameSource {
+ public:
+  SharedMemoryFrameSource(const std::string &name, uint32_t width, uint32_t height)
+      : m_sharedMemory{new cluon::SharedMemory{name}}
+      , m_width{width}
+      , m_height{height} {}
+
+  bool valid() const noexcept {
+    return m_sharedMemory && m_sharedMemory->valid();
+  }
+
+  const cluon::SharedMemory &sharedMemory() const noexcept {
+    return *m_sharedMemory;
+  }
+
+  // Block until the writer announces the next frame.
+  void wait() {
+    m_sharedMemory->wait();
+  }
+
+  // Copy the current frame into img, reusing its buffer, and return its
+  // sample time stamp in microseconds.
+  uint64_t grab(cv::Mat &img) {
+    // Lock the shared memory.
+    m_sharedMemory->lock();
+    {
+      // Copy the pixels from the shared memory into our own data structure.
+      cv::Mat wrapped(static_cast<int>(m_height), static_cast<int>(m_width), CV_8UC4, m_sharedMemory->data());
+      wrapped.copyTo(img);
+    }
+
+    std::pair<bool, cluon::data::TimeStamp> sTime = m_sharedMemory->getTimeStamp(); // Saving current time in sTime var
+
+    //Shared memory is unlocked
+    m_sharedMemory->unlock();
+
+    // Convert TimeStamp obj into microseconds
+    return static_cast<uint64_t>(cluon::time::toMicroseconds(sTime.second));
+  }
+
+  uint32_t width() const noexcept {
+    return m_width;
+  }
+
+  uint32_t height() const noexcept {
+    return m_height;
+  }
+
+ private:
+  std::unique_ptr<cluon::SharedMemory> m_sharedMemory;
+  uint32_t m_width;
+  uint32_t m_height;
+};
+
+#endif
@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+
+// Fixed-size histogram of durations in nanoseconds with a bounded relative
+// error, in the manner of an HDR histogram.
+//
+// Values below 2 * SUB_BUCKETS get a bucket each. Above, every power of two is
+// split into SUB_BUCKETS linear buckets, so a bucket is at most 1/SUB_BUCKETS
+// (about 3%) wider than its lower bound. Recording is a few shifts and an
+// increment without allocation. Values from 2^MAX_BITS ns (about 68 s) on
+// share the last bucket; the maximum is kept exactly.
+class LatencyHistogram {
+ public:
+  static constexpr uint32_t SUB_BUCKET_BITS{5};
+  static constexpr uint32_t SUB_BUCKETS{1u << SUB_BUCKET_BITS};
+  static constexpr uint32_t MAX_BITS{36};
+  static constexpr uint32_t NUMBER_OF_BUCKETS{2 * SUB_BUCKETS + (MAX_BITS - SUB_BUCKET_BITS - 1) * SUB_BUCKETS};
+
+ public:
+  void record(uint64_t value) noexcept {
+    m_buckets[indexOf(value)]++;
+    m_count++;
+    m_max = std::max(m_max, value);
+  }
+
+  void merge(const LatencyHistogram &other) noexcept {
+    for (uint32_t i{0}; i < NUMBER_OF_BUCKETS; i++) {
+      m_buckets[i] += other.m_buckets[i];
+    }
+    m_count += other.m_count;
+    m_max = std::max(m_max, other.m_max);
+  }
+
+  void reset() noexcept {
+    std::fill(m_buckets, m_buckets + NUMBER_OF_BUCKETS, 0);
+    m_count = 0;
+    m_max = 0;
+  }
+
+  uint64_t count() const noexcept {
+    return m_count;
+  }
+
+  uint64_t max() const noexcept {
+    return m_max;
+  }
+
+  // Smallest bucket bound that at least the share p (0..1] of the values do
+  // not exceed; never more than max().
+  uint64_t percentile(double p) const noexcept {
+    if (0 == m_count) {
+      return 0;
+    }
+    const uint64_t rank{std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p * static_cast<double>(m_count))))};
+    uint64_t seen{0};
+    for (uint32_t i{0}; i < NUMBER_OF_BUCKETS; i++) {
+      seen += m_buckets[i];
+      if (seen >= rank) {
+        return std::min(m_max, highestValueOf(i));
+      }
+    }
+    return m_max;
+  }
+
+ private:
+  static uint32_t indexOf(uint64_t value) noexcept {
+    if (value < 2 * SUB_BUCKETS) {
+      return static_cast<uint32_t>(value);
+    }
+    const uint32_t msb{63u - static_cast<uint32_t>(__builtin_clzll(value))};
+    if (msb >= MAX_BITS) {
+      return NUMBER_OF_BUCKETS - 1;
+    }
+    const uint32_t shift{msb - SUB_BUCKET_BITS};
+    return 2 * SUB_BUCKETS + (shift - 1) * SUB_BUCKETS + static_cast<uint32_t>((value >> shift) - SUB_BUCKETS);
+  }
+
+  static uint64_t highestValueOf(uint32_t index) noexcept {
+    if (index < 2 * SUB_BUCKETS) {
+      return index;
+    }
+    if (NUMBER_OF_BUCKETS - 1 == index) {
+      return UINT64_MAX;
+    }
+    const uint32_t shift{(index - 2 * SUB_BUCKETS) / SUB_BUCKETS + 1};
+    const uint64_t subBucket{(index - 2 * SUB_BUCKETS) % SUB_BUCKETS + SUB_BUCKETS};
+    return ((subBucket + 1) << shift) - 1;
+  }
+
+ private:
+  uint64_t m_buckets[NUMBER_OF_BUCKETS] = {};
+  uint64_t m_count{0};
+  uint64_t m_max{0};
+};
+
+// Write ";p50;p90;p99;max" of histogram in milliseconds.
+inline void writePercentilesInMilliseconds(std::ostream &out, const LatencyHistogram &histogram) {
+  auto inMilliseconds = [](uint64_t nanoseconds) {
+    return static_cast<double>(nanoseconds) / 1e6;
+  };
+  const std::streamsize precision{out.precision()};
+  out << std::fixed << std::setprecision(3) << ";" << inMilliseconds(histogram.percentile(0.5)) << ";" << inMilliseconds(histogram.percentile(0.9))
+      << ";" << inMilliseconds(histogram.percentile(0.99)) << ";" << inMilliseconds(histogram.max()) << std::defaultfloat << std::setprecision(precision);
+}
+
+#endif
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LATEST_VALUE_HPP
+#define LATEST_VALUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+// Single-writer, multi-reader cell holding the most recent value of a message.
+//
+// The cell is a sequence lock: the writer bumps the sequence counter to an odd
+// value, stores the payload and bumps it to the next even value. Readers copy
+// the payload and retry if the counter changed or was odd meanwhile. Neither
+// side ever blocks the other, so the OD4 receiver thread and the frame loop do
+// not contend. The payload is kept in atomic words to avoid a data race on torn
+// reads; hence, T must be trivially copyable (e.g. opendlv.proxy readings and
+// requests consisting of numerical fields only).
+template <typename T>
+class LatestValue {
+  static_assert(std::is_trivially_copyable<T>::value, "LatestValue<T> requires a trivially copyable T");
+  static_assert(std::is_default_constructible<T>::value, "LatestValue<T> requires a default constructible T");
+
+ private:
+  static constexpr std::size_t WORDS{(sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t)};
+
+ public:
+  LatestValue() noexcept {
+    const T initial{};
+    writeWords(initial);
+  }
+  LatestValue(const LatestValue &) = delete;
+  LatestValue &operator=(const LatestValue &) = delete;
+
+  // Publish a new value; must only be called from one thread at a time.
+  void store(const T &value) noexcept {
+    const uint64_t seq{m_sequence.load(std::memory_order_relaxed)};
+    m_sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    writeWords(value);
+    m_sequence.store(seq + 2, std::memory_order_release);
+  }
+
+  // Return a consistent copy of the most recent value; safe from any thread.
+  T load() const noexcept {
+    T retVal;
+    version(retVal);
+    return retVal;
+  }
+
+  // Copy the most recent value into out and return the number of stores that
+  // produced it; compare with a previous result to detect fresh data.
+  uint64_t version(T &out) const noexcept {
+    uint64_t words[WORDS];
+    uint64_t before{0};
+    for (;;) {
+      before = m_sequence.load(std::memory_order_acquire);
+      if (0 == (before & 1)) {
+        for (std::size_t i{0}; i < WORDS; i++) {
+          words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (before == m_sequence.load(std::memory_order_relaxed)) {
+          break;
+        }
+      }
+      std::this_thread::yield();
+    }
+    std::memcpy(&out, words, sizeof(T));
+    return before / 2;
+  }
+
+  // Return the number of stores so far without copying the payload.
+  uint64_t version() const noexcept {
+    return m_sequence.load(std::memory_order_acquire) / 2;
+  }
+
+ private:
+  void writeWords(const T &value) noexcept {
+    uint64_t words[WORDS] = {};
+    std::memcpy(words, &value, sizeof(T));
+    for (std::size_t i{0}; i < WORDS; i++) {
+      m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  std::atomic<uint64_t> m_sequence{0};
+  std::atomic<uint64_t> m_words[WORDS];
+};
+
+#endif
@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OFFLINE_REPLAY_HPP
+#define OFFLINE_REPLAY_HPP
+
+#include "cluon-complete.hpp"
+#include "opendlv-standard-message-set.hpp"
+
+#include "frame-recording.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Clock that only advances with the sample time stamps of the replayed
+// envelopes; it never looks at wall time.
+class VirtualClock {
+ public:
+  // Return the current time in microseconds.
+  int64_t now() const noexcept {
+    return m_now;
+  }
+
+  // Move the clock forward; time stamps from the past are ignored.
+  void advanceTo(int64_t timeStampInMicroseconds) noexcept {
+    if (timeStampInMicroseconds > m_now) {
+      m_now = timeStampInMicroseconds;
+    }
+  }
+
+ private:
+  int64_t m_now{0};
+};
+
+// Counters of one offline replay.
+struct OfflineReplayStatistics {
+  uint64_t frames{0};
+  uint64_t skippedFrames{0}; // ImageReadings not in a raw pixel format
+  uint64_t groundSteeringRequests{0};
+};
+
+// Feeds the frames and GroundSteeringRequests of a recording into a delegate as
+// fast as the CPU allows instead of pacing them by cluon::Player::delay().
+//
+// Envelopes are replayed in the order of their sample time stamps, which also
+// drive a VirtualClock. A frame is handed over together with the latest
+// GroundSteeringRequest whose sample time stamp is not after the frame's, so
+// repeated runs over the same recording produce the same results regardless of
+// CPU speed or load. Frames must be opendlv.proxy.ImageReading with raw pixels
+// in the layout the live microservice reads from shared memory (fourcc "BGRA",
+// 4 bytes per pixel); compressed frames are counted as skipped.
+//
+// Alternatively, the frames are taken from a file written by frame-capture and
+// only the GroundSteeringRequests from the recording; both are merged by their
+// sample time stamps. This covers recordings with h264 video, whose decoded
+// frames were captured once from the h264decoder.
+class OfflineReplay {
+ public:
+  static constexpr const char *FOURCC_BGRA{"BGRA"};
+
+  // The frame is only valid during the call; clone it to keep it.
+  using FrameDelegate = std::function<void(const cv::Mat &frame, int64_t sampleTimeStamp, const opendlv::proxy::GroundSteeringRequest &gsr)>;
+
+ public:
+  explicit OfflineReplay(const std::string &recFile, const std::string &framesFile = "") noexcept
+      : m_recFile{recFile}
+      , m_framesFile{framesFile} {}
+
+  // Return <recording>.frames next to the given recording if it exists, or "".
+  static std::string framesFileFor(const std::string &recFile) {
+    const std::string REC_EXTENSION{".rec"};
+    std::string framesFile{recFile};
+    if ((framesFile.size() > REC_EXTENSION.size()) && (0 == framesFile.compare(framesFile.size() - REC_EXTENSION.size(), REC_EXTENSION.size(), REC_EXTENSION))) {
+      framesFile.erase(framesFile.size() - REC_EXTENSION.size());
+    }
+    framesFile += ".frames";
+    return (0 == ::access(framesFile.c_str(), R_OK)) ? framesFile : "";
+  }
+
+  // Replay the whole recording once; returns false if it cannot be opened.
+  bool run(FrameDelegate delegate) {
+    constexpr bool AUTO_REWIND{false};
+    constexpr bool THREADING{false};
+    constexpr bool MEMORY_MAPPED{true};
+    cluon::Player player(m_recFile, AUTO_REWIND, THREADING, MEMORY_MAPPED);
+    if (0 == player.totalNumberOfEnvelopesInRecFile()) {
+      return false;
+    }
+
+    std::unique_ptr<FrameRecordingReader> frames;
+    std::vector<char> pixels;
+    if (!m_framesFile.empty()) {
+      frames.reset(new FrameRecordingReader{m_framesFile});
+      if (!frames->valid() || (4 != frames->bytesPerPixel())) {
+        return false;
+      }
+      // Pixels outside of a recorded region stay black like in frame-replay.
+      pixels.assign(static_cast<std::size_t>(frames->width()) * frames->height() * frames->bytesPerPixel(), 0);
+    }
+    std::size_t nextFrame{0};
+
+    m_clock = VirtualClock{};
+    m_statistics = OfflineReplayStatistics{};
+    opendlv::proxy::GroundSteeringRequest gsr;
+
+    // Hand over the captured frames sampled before the next envelope. A frame
+    // sampled at the same time as a GroundSteeringRequest is not before it: it
+    // waits until the player reaches a later time stamp, so the request is
+    // applied first and the frame gets the latest one not after it. The player
+    // replays the envelopes ordered by their sample time stamps.
+    auto replayFramesSampledBefore = [&](int64_t envelopeTimeStamp) {
+      for (; frames && (nextFrame < frames->size()) && (frames->sampleTimeStamp(nextFrame) < envelopeTimeStamp); nextFrame++) {
+        const int64_t frameTimeStamp{frames->sampleTimeStamp(nextFrame)};
+        m_clock.advanceTo(frameTimeStamp);
+        frames->copyFrameTo(nextFrame, &pixels[0]);
+        const cv::Mat frame(static_cast<int>(frames->height()), static_cast<int>(frames->width()), CV_8UC4, &pixels[0]);
+        m_statistics.frames++;
+        delegate(frame, frameTimeStamp, gsr);
+      }
+    };
+
+    while (player.hasMoreData()) {
+      auto next = player.getNextEnvelopeToBeReplayed();
+      if (!next.first) {
+        continue;
+      }
+      cluon::data::Envelope &env{next.second};
+      const int64_t sampleTimeStamp{cluon::time::toMicroseconds(env.sampleTimeStamp())};
+      replayFramesSampledBefore(sampleTimeStamp);
+      m_clock.advanceTo(sampleTimeStamp);
+
+      if (opendlv::proxy::GroundSteeringRequest::ID() == env.dataType()) {
+        if (cluon::extractMessage(std::move(env), m_gsrDecoder)) {
+          gsr = m_gsrDecoder.field(GROUND_STEERING_FIELD_ID);
+          m_statistics.groundSteeringRequests++;
+        }
+      } else if (!frames && (opendlv::proxy::ImageReading::ID() == env.dataType())) {
+        const opendlv::proxy::ImageReading reading{cluon::extractMessage<opendlv::proxy::ImageReading>(std::move(env))};
+        std::string data{reading.data()};
+        const std::size_t expectedSize{static_cast<std::size_t>(reading.width()) * reading.height() * 4};
+        if ((FOURCC_BGRA != reading.fourcc()) || (0 == expectedSize) || (expectedSize != data.size())) {
+          m_statistics.skippedFrames++;
+          continue;
+        }
+        // Wraps the decoded bytes like the shared memory is wrapped in the live microservice.
+        const cv::Mat frame(static_cast<int>(reading.height()), static_cast<int>(reading.width()), CV_8UC4, &data[0]);
+        m_statistics.frames++;
+        delegate(frame, sampleTimeStamp, gsr);
+      }
+    }
+    replayFramesSampledBefore(std::numeric_limits<int64_t>::max());
+    return true;
+  }
+
+  // Virtual time of the envelope replayed last, in microseconds.
+  int64_t now() const noexcept {
+    return m_clock.now();
+  }
+
+  const OfflineReplayStatistics &statistics() const noexcept {
+    return m_statistics;
+  }
+
+ private:
+  // Field groundSteering [id = 1] of opendlv.proxy.GroundSteeringRequest
+  static constexpr uint32_t GROUND_STEERING_FIELD_ID{1};
+
+  std::string m_recFile;
+  std::string m_framesFile;
+  VirtualClock m_clock{};
+  OfflineReplayStatistics m_statistics{};
+  cluon::LazyProtoDecoder<opendlv::proxy::GroundSteeringRequest> m_gsrDecoder{};
+};
+
+#endif
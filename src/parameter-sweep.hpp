@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARAMETER_SWEEP_HPP
+#define PARAMETER_SWEEP_HPP
+
+#include "steering-detector.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <istream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// A parameter of SteeringDetectorConfig together with the values to try.
+struct SweptParameter {
+  std::string name;
+  std::vector<double> values;
+};
+
+// Set the parameter with the given name; returns false for unknown names.
+// Names are those of the SteeringDetectorConfig fields, with the HSV bounds
+// prefixed by their colour (e.g. blue.minHue, yellow.maxValue).
+inline bool applyParameter(SteeringDetectorConfig &config, const std::string &name, double value) {
+  const int asInt{static_cast<int>(std::lround(value))};
+  const float asFloat{static_cast<float>(value)};
+  for (HsvRange *range : {&config.blue, &config.yellow}) {
+    const std::string prefix{(range == &config.blue) ? "blue." : "yellow."};
+    if (0 != name.compare(0, prefix.size(), prefix)) {
+      continue;
+    }
+    const std::string field{name.substr(prefix.size())};
+    int *target{("minHue" == field) ? &range->minHue
+              : ("maxHue" == field) ? &range->maxHue
+              : ("minSat" == field) ? &range->minSat
+              : ("maxSat" == field) ? &range->maxSat
+              : ("minValue" == field) ? &range->minValue
+              : ("maxValue" == field) ? &range->maxValue
+              : nullptr};
+    if (nullptr != target) {
+      *target = asInt;
+    }
+    return nullptr != target;
+  }
+  if ("frameSampleSize" == name) {
+    config.frameSampleSize = asInt;
+  } else if ("identifiedShape" == name) {
+    config.identifiedShape = asInt;
+  } else if ("steeringMax" == name) {
+    config.steeringMax = asFloat;
+  } else if ("steeringMin" == name) {
+    config.steeringMin = asFloat;
+  } else if ("carTurnR" == name) {
+    config.carTurnR = asFloat;
+  } else if ("carTurnL" == name) {
+    config.carTurnL = asFloat;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// Search space for SteeringDetectorConfig, read from lines like
+//   blue.minHue = 90:110:5        (first:last:step, last included)
+//   carTurnR    = 0.02,0.025,0.03 (list)
+// where '#' starts a comment. Parameters that are not listed keep the value
+// of the base configuration.
+class ParameterSweep {
+ public:
+  // A configuration as one value per parameter, in the order of parameters().
+  using Values = std::vector<double>;
+
+ public:
+  bool parse(std::istream &in, std::string &error) {
+    m_parameters.clear();
+    std::string line;
+    for (uint32_t lineNumber{1}; std::getline(in, line); lineNumber++) {
+      line = line.substr(0, line.find('#'));
+      if (std::string::npos == line.find_first_not_of(" \t\r")) {
+        continue;
+      }
+      const std::size_t equals{line.find('=')};
+      SweptParameter parameter{trim(line.substr(0, equals)), {}};
+      SteeringDetectorConfig probe;
+      if ((std::string::npos == equals) || !applyParameter(probe, parameter.name, 0.0) || !parseValues(trim(line.substr(equals + 1)), parameter.values)) {
+        error = "line " + std::to_string(lineNumber) + ": expected <parameter> = <first>:<last>:<step> or <value>,<value>,...";
+        return false;
+      }
+      m_parameters.push_back(parameter);
+    }
+    return true;
+  }
+
+  const std::vector<SweptParameter> &parameters() const noexcept {
+    return m_parameters;
+  }
+
+  // Number of configurations in the full grid; saturates at UINT64_MAX.
+  uint64_t gridSize() const noexcept {
+    uint64_t size{1};
+    for (const auto &parameter : m_parameters) {
+      const uint64_t n{parameter.values.size()};
+      size = (size > UINT64_MAX / n) ? UINT64_MAX : size * n;
+    }
+    return size;
+  }
+
+  // Every combination of the parameter values.
+  std::vector<Values> grid() const {
+    std::vector<Values> configurations;
+    std::vector<std::size_t> indices(m_parameters.size(), 0);
+    for (uint64_t i{0}; i < gridSize(); i++) {
+      configurations.push_back(valuesAt(indices));
+      // Count up like an odometer with the last parameter changing fastest.
+      for (std::size_t p{indices.size()}; 0 < p; p--) {
+        if (++indices[p - 1] < m_parameters[p - 1].values.size()) {
+          break;
+        }
+        indices[p - 1] = 0;
+      }
+    }
+    return configurations;
+  }
+
+  // Configurations with a value drawn uniformly per parameter; the same seed
+  // gives the same configurations.
+  std::vector<Values> random(uint64_t numberOfSamples, uint32_t seed) const {
+    std::mt19937 generator{seed};
+    std::vector<Values> configurations;
+    std::vector<std::size_t> indices(m_parameters.size(), 0);
+    for (uint64_t i{0}; i < numberOfSamples; i++) {
+      for (std::size_t p{0}; p < m_parameters.size(); p++) {
+        std::uniform_int_distribution<std::size_t> distribution{0, m_parameters[p].values.size() - 1};
+        indices[p] = distribution(generator);
+      }
+      configurations.push_back(valuesAt(indices));
+    }
+    return configurations;
+  }
+
+  // True if no swept parameter changes what the cone segmentation finds; such
+  // a sweep needs the cached blobs of the recordings only.
+  bool controllerOnly() const noexcept {
+    for (const auto &parameter : m_parameters) {
+      if (0 == parameter.name.compare(0, 5, "blue.") || 0 == parameter.name.compare(0, 7, "yellow.")) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  SteeringDetectorConfig configFor(const Values &values, const SteeringDetectorConfig &base = SteeringDetectorConfig{}) const {
+    SteeringDetectorConfig config{base};
+    for (std::size_t p{0}; (p < m_parameters.size()) && (p < values.size()); p++) {
+      applyParameter(config, m_parameters[p].name, values[p]);
+    }
+    return config;
+  }
+
+ private:
+  static std::string trim(const std::string &s) {
+    const std::size_t first{s.find_first_not_of(" \t\r")};
+    const std::size_t last{s.find_last_not_of(" \t\r")};
+    return (std::string::npos == first) ? "" : s.substr(first, last - first + 1);
+  }
+
+  static bool parseValues(const std::string &s, std::vector<double> &values) {
+    try {
+      if (std::string::npos != s.find(':')) {
+        std::stringstream sstr{s};
+        std::string first, last, step;
+        if (!std::getline(sstr, first, ':') || !std::getline(sstr, last, ':') || !std::getline(sstr, step)) {
+          return false;
+        }
+        const double from{std::stod(first)};
+        const double to{std::stod(last)};
+        const double by{std::stod(step)};
+        if (!(0.0 < by) || (to < from)) {
+          return false;
+        }
+        // The small epsilon keeps the last value despite rounding of the step.
+        const uint64_t n{static_cast<uint64_t>(std::floor((to - from) / by + 1e-9)) + 1};
+        for (uint64_t i{0}; i < n; i++) {
+          values.push_back(from + static_cast<double>(i) * by);
+        }
+      } else {
+        std::stringstream sstr{s};
+        std::string value;
+        while (std::getline(sstr, value, ',')) {
+          values.push_back(std::stod(value));
+        }
+      }
+    } catch (...) {
+      return false;
+    }
+    return !values.empty();
+  }
+
+  Values valuesAt(const std::vector<std::size_t> &indices) const {
+    Values values;
+    for (std::size_t p{0}; p < m_parameters.size(); p++) {
+      values.push_back(m_parameters[p].values[indices[p]]);
+    }
+    return values;
+  }
+
+ private:
+  std::vector<SweptParameter> m_parameters{};
+};
+
+#endif
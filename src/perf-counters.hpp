@@ -0,0 +1,138 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// Hardware counters of the calling thread, read as one group so that all of
+// them cover the same instructions.
+//
+// Counters are not available everywhere: containers and virtual machines often
+// hide them and kernel.perf_event_paranoid may forbid them. Then valid() is
+// false and error() says why; a single missing counter is only reported as
+// such by has(). Only user space is counted.
+class PerfCounters {
+ public:
+  enum Counter : uint32_t {
+    CYCLES = 0,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    NUMBER_OF_COUNTERS,
+  };
+
+  struct Values {
+    uint64_t value[NUMBER_OF_COUNTERS];
+  };
+
+  static const char *name(Counter counter) noexcept {
+    static const char *NAMES[NUMBER_OF_COUNTERS]{"cycles", "instructions", "cache_misses", "branch_misses"};
+    return (counter < NUMBER_OF_COUNTERS) ? NAMES[counter] : "?";
+  }
+
+ public:
+  PerfCounters() noexcept {
+    static const uint64_t CONFIGS[NUMBER_OF_COUNTERS]{PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (uint32_t i{0}; i < NUMBER_OF_COUNTERS; i++) {
+      const int leader{m_fds[CYCLES]};
+      if ((CYCLES != i) && (0 > leader)) {
+        break;
+      }
+      struct perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = CONFIGS[i];
+      attr.disabled = (CYCLES == i) ? 1 : 0;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      m_fds[i] = static_cast<int>(::syscall(__NR_perf_event_open, &attr, 0, -1, (CYCLES == i) ? -1 : leader, 0));
+      if (0 <= m_fds[i]) {
+        m_members[m_numberOfMembers++] = static_cast<Counter>(i);
+      } else if (CYCLES == i) {
+        m_error = std::string{"perf_event_open: "} + std::strerror(errno) + ((EACCES == errno) || (EPERM == errno) ? " (see /proc/sys/kernel/perf_event_paranoid)" : "");
+      }
+    }
+    if (valid()) {
+      ::ioctl(m_fds[CYCLES], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ::ioctl(m_fds[CYCLES], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+  }
+
+  ~PerfCounters() {
+    for (int fd : m_fds) {
+      if (0 <= fd) {
+        ::close(fd);
+      }
+    }
+  }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  bool valid() const noexcept {
+    return 0 <= m_fds[CYCLES];
+  }
+
+  bool has(Counter counter) const noexcept {
+    return (counter < NUMBER_OF_COUNTERS) && (0 <= m_fds[counter]);
+  }
+
+  const std::string &error() const noexcept {
+    return m_error;
+  }
+
+  // Read the counts since opening, scaled up if the kernel had to share the
+  // counters with others; missing counters read as 0.
+  bool read(Values &values) const noexcept {
+    uint64_t buffer[3 + NUMBER_OF_COUNTERS] = {};
+    std::memset(&values, 0, sizeof(values));
+    if (!valid() || (0 >= ::read(m_fds[CYCLES], buffer, sizeof(buffer)))) {
+      return false;
+    }
+    const uint64_t numberOfMembers{buffer[0]};
+    const uint64_t timeEnabled{buffer[1]};
+    const uint64_t timeRunning{buffer[2]};
+    for (uint64_t i{0}; (i < numberOfMembers) && (i < m_numberOfMembers); i++) {
+      uint64_t value{buffer[3 + i]};
+      if ((0 < timeRunning) && (timeRunning < timeEnabled)) {
+        value = static_cast<uint64_t>(static_cast<double>(value) * static_cast<double>(timeEnabled) / static_cast<double>(timeRunning));
+      }
+      values.value[m_members[i]] = value;
+    }
+    return true;
+  }
+
+ private:
+  int m_fds[NUMBER_OF_COUNTERS]{-1, -1, -1, -1};
+  Counter m_members[NUMBER_OF_COUNTERS]{};
+  uint32_t m_numberOfMembers{0};
+  std::string m_error{};
+};
+
+#endif
@@ -0,0 +1,343 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Include the single-file, header-only middleware libcluon to create high-performance microservices
+#include "cluon-complete.hpp"
+
+#include "cluon-complete.cpp"
+
+// Include the cone detection, the time measurement per stage, and the frames to measure with
+#include "steering-detector.hpp"
+#include "stage-profiler.hpp"
+#include "frame-recording.hpp"
+#include "synthetic-frames.hpp"
+
+#ifndef STAGE_PROFILING
+#error "perf-gate measures the stages with StageProfiler and must be built with STAGE_PROFILING"
+#endif
+
+#include <sched.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Stages that depend on the code of this repository; waiting for frames and the output are left out.
+static const std::vector < PipelineStage::Id > STAGES {
+  PipelineStage::LOCK_AND_CLONE, PipelineStage::CVT_COLOR, PipelineStage::IN_RANGE, PipelineStage::BLUR_AND_MORPH, PipelineStage::FIND_CONTOURS, PipelineStage::STEERING
+};
+static const std::string FRAME {
+  "frame"
+};
+
+// Median and 99th percentile of a stage in milliseconds.
+struct Timing {
+  double median {
+    0.0
+  };
+  double p99 {
+    0.0
+  };
+};
+
+static double inMilliseconds(uint64_t nanoseconds) {
+  return static_cast < double > (nanoseconds) / 1e6;
+}
+
+static double medianOf(std::vector < double > values) {
+  std::sort(values.begin(), values.end());
+  return values.empty() ? 0.0 : values[values.size() / 2];
+}
+
+// Read "stage;median_ms;p99_ms" lines; '#' starts a comment, and a comment "# <key>: <value>" with a key without spaces is a header field.
+static bool readBaseline(const std::string & file, std::map < std::string, Timing > & baseline, std::map < std::string, std::string > & fields) {
+  std::ifstream in(file);
+  std::string line;
+  while (in.good() && std::getline(in, line)) {
+    if ((0 == line.find("# ")) && (std::string::npos != line.find(": "))) {
+      const std::string key {
+        line.substr(2, line.find(": ") - 2)
+      };
+      if (!key.empty() && (std::string::npos == key.find(' '))) {
+        fields[key] = line.substr(line.find(": ") + 2);
+      }
+    }
+    line = line.substr(0, line.find('#'));
+    std::stringstream sstr {
+      line
+    };
+    std::string stage, median, p99;
+    if (std::getline(sstr, stage, ';') && std::getline(sstr, median, ';') && std::getline(sstr, p99)) {
+      try {
+        baseline[stage] = Timing {
+          std::stod(median), std::stod(p99)
+        };
+      } catch (...) {
+        // The header line
+      }
+    }
+  }
+  return !baseline.empty();
+}
+
+int32_t main(int32_t argc, char ** argv) {
+  int32_t retCode {
+    1
+  };
+  auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  if ((0 == commandlineArguments.count("baseline")) && (0 == commandlineArguments.count("write-baseline"))) {
+    std::cerr << argv[0] << " compares the time per stage of the cone detection with a baseline and fails on regressions." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --baseline=<file> | --write-baseline=<file> [--frames=<file>] [--size=<width>x<height>] [--count=<n>]" << std::endl;
+    std::cerr << "         [--warmup=<n>] [--trials=<n>] [--passes=<n>] [--cpu=<n>] [--tolerance=<share>] [--p99-tolerance=<share>] [--min-delta=<ms>] [--generic]" << std::endl;
+    std::cerr << "         --baseline:       file with stage;median_ms;p99_ms to compare with" << std::endl;
+    std::cerr << "         --write-baseline: measure and write the baseline for this machine instead" << std::endl;
+    std::cerr << "         --frames:         frames recorded with frame-capture; default: synthetic frames" << std::endl;
+    std::cerr << "         --size:           size of the synthetic frames; default: 640x480" << std::endl;
+    std::cerr << "         --count:          number of synthetic frames; default: 64" << std::endl;
+    std::cerr << "         --warmup:         frames processed before measuring; default: 50" << std::endl;
+    std::cerr << "         --trials:         independent measurements; their median is compared; default: 5" << std::endl;
+    std::cerr << "         --passes:         passes over all frames per trial; default: 4" << std::endl;
+    std::cerr << "         --cpu:            run on this core only" << std::endl;
+    std::cerr << "         --tolerance:      allowed increase of the median; default: 0.1 (10%)" << std::endl;
+    std::cerr << "         --p99-tolerance:  allowed increase of the 99th percentile; default: 0.25 (25%)" << std::endl;
+    std::cerr << "         --min-delta:      increases below this many ms are never regressions; default: 0.05" << std::endl;
+    std::cerr << "         --generic:        do not use the kernels specialized for the regions of interest" << std::endl;
+    std::cerr << "Example: " << argv[0] << " --baseline=perf-baseline.csv --cpu=2" << std::endl;
+  } else {
+    const uint32_t WARMUP {
+      (0 != commandlineArguments.count("warmup")) ? static_cast < uint32_t > (std::stoi(commandlineArguments["warmup"])) : 50
+    };
+    const uint32_t TRIALS {
+      (0 != commandlineArguments.count("trials")) ? std::max(1, std::stoi(commandlineArguments["trials"])) : 5u
+    };
+    const uint32_t PASSES {
+      (0 != commandlineArguments.count("passes")) ? std::max(1, std::stoi(commandlineArguments["passes"])) : 4u
+    };
+    const double TOLERANCE {
+      (0 != commandlineArguments.count("tolerance")) ? std::stod(commandlineArguments["tolerance"]) : 0.1
+    };
+    const double P99_TOLERANCE {
+      (0 != commandlineArguments.count("p99-tolerance")) ? std::stod(commandlineArguments["p99-tolerance"]) : 0.25
+    };
+    const double MIN_DELTA {
+      (0 != commandlineArguments.count("min-delta")) ? std::stod(commandlineArguments["min-delta"]) : 0.05
+    };
+    const bool SPECIALIZED {
+      0 == commandlineArguments.count("generic")
+    };
+    const std::string MODE {
+      SPECIALIZED ? "specialized" : "generic"
+    };
+
+    // Another process on the same core would show up as a regression; pinning keeps the caches and the clock of one core.
+    if (0 != commandlineArguments.count("cpu")) {
+      cpu_set_t cpus;
+      CPU_ZERO( & cpus);
+      CPU_SET(std::stoi(commandlineArguments["cpu"]), & cpus);
+      if (0 != ::sched_setaffinity(0, sizeof(cpus), & cpus)) {
+        std::clog << argv[0] << ": Could not pin to core " << commandlineArguments["cpu"] << "; measuring anyway." << std::endl;
+      }
+    }
+    // OpenCV's threads would run on other cores and make the results depend on the load of the machine.
+    cv::setNumThreads(1);
+
+    // The corpus: captured frames or synthetic ones.
+    std::vector < cv::Mat > frames;
+    SteeringDetectorConfig config;
+    std::string corpus;
+    if (0 != commandlineArguments.count("frames")) {
+      FrameRecordingReader reader(commandlineArguments["frames"]);
+      const FrameRegion & region {
+        reader.region()
+      };
+      const cv::Rect roi {
+        config.boundingRegionOfInterest()
+      };
+      if (!reader.valid() || (4 != reader.bytesPerPixel()) || (0 == reader.size())) {
+        std::cerr << argv[0] << ": '" << commandlineArguments["frames"] << "' has no BGRA frames." << std::endl;
+        return retCode;
+      }
+      if ((roi & cv::Rect(static_cast < int > (region.x), static_cast < int > (region.y), static_cast < int > (region.width), static_cast < int > (region.height))) != roi) {
+        std::cerr << argv[0] << ": '" << commandlineArguments["frames"] << "' does not contain the regions of interest." << std::endl;
+        return retCode;
+      }
+      for (std::size_t i = 0; i < reader.size(); i++) {
+        cv::Mat frame = cv::Mat::zeros(static_cast < int > (reader.height()), static_cast < int > (reader.width()), CV_8UC4);
+        reader.copyFrameTo(i, reinterpret_cast < char * > (frame.data));
+        frames.push_back(frame);
+      }
+      corpus = commandlineArguments["frames"];
+    } else {
+      int width {
+        640
+      };
+      int height {
+        480
+      };
+      if ((0 != commandlineArguments.count("size")) && (2 != std::sscanf(commandlineArguments["size"].c_str(), "%dx%d", & width, & height))) {
+        std::cerr << argv[0] << ": Expected --size=<width>x<height>." << std::endl;
+        return retCode;
+      }
+      const uint32_t COUNT {
+        (0 != commandlineArguments.count("count")) ? std::max(1, std::stoi(commandlineArguments["count"])) : 64u
+      };
+      for (uint32_t i = 0; i < COUNT; i++) {
+        frames.push_back(SyntheticFrames::frame(cv::Size(width, height), i));
+      }
+      config = SyntheticFrames::config(cv::Size(width, height));
+      corpus = "synthetic " + std::to_string(width) + "x" + std::to_string(height);
+    }
+
+    // Check the baseline before measuring for minutes.
+    std::map < std::string, Timing > baseline;
+    if (0 == commandlineArguments.count("write-baseline")) {
+      std::map < std::string, std::string > fields;
+      if (!readBaseline(commandlineArguments["baseline"], baseline, fields)) {
+        std::cerr << argv[0] << ": Could not read a baseline from '" << commandlineArguments["baseline"] << "'." << std::endl;
+        return retCode;
+      }
+      // The generic kernels are slower by design and another corpus takes other times; neither comparison says anything about a change.
+      if (MODE != fields["mode"]) {
+        std::cerr << argv[0] << ": The baseline was measured with the " << (fields["mode"].empty() ? "unknown" : fields["mode"]) << " kernels, this run uses the " << MODE << " kernels; write the baseline again." << std::endl;
+        return retCode;
+      }
+      if (corpus != fields["corpus"]) {
+        std::cerr << argv[0] << ": The baseline was measured on '" << fields["corpus"] << "', this run on '" << corpus << "'; write the baseline again." << std::endl;
+        return retCode;
+      }
+    }
+
+    // Warm up the caches, the allocator and the clock frequency without measuring.
+    {
+      SteeringDetector detector {
+        config
+      };
+      detector.setSpecialized(SPECIALIZED);
+      for (uint32_t i = 0; i < WARMUP; i++) {
+        detector.process(frames[i % frames.size()].clone());
+      }
+    }
+
+    // Every trial runs a fresh detector over the same frames; the median over the trials is robust against a disturbed trial.
+    std::map < std::string, std::vector < double > > medians;
+    std::map < std::string, std::vector < double > > p99s;
+    StageProfiler profiler {
+      std::chrono::seconds(0)
+    };
+    for (uint32_t trial = 0; trial < TRIALS; trial++) {
+      SteeringDetector detector {
+        config
+      };
+      detector.setProfiler( & profiler);
+      detector.setSpecialized(SPECIALIZED);
+      profiler.reset();
+      LatencyHistogram frameTimes;
+      for (uint32_t pass = 0; pass < PASSES; pass++) {
+        for (const cv::Mat & frame: frames) {
+          const auto start = std::chrono::steady_clock::now();
+          cv::Mat img;
+          {
+            StageTimer timer {
+              & profiler, PipelineStage::LOCK_AND_CLONE
+            };
+            img = frame.clone();
+          }
+          detector.process(img);
+          frameTimes.record(static_cast < uint64_t > (std::chrono::duration_cast < std::chrono::nanoseconds > (std::chrono::steady_clock::now() - start).count()));
+        }
+      }
+      for (PipelineStage::Id stage: STAGES) {
+        medians[PipelineStage::name(stage)].push_back(inMilliseconds(profiler.histogram(stage).percentile(0.5)));
+        p99s[PipelineStage::name(stage)].push_back(inMilliseconds(profiler.histogram(stage).percentile(0.99)));
+      }
+      medians[FRAME].push_back(inMilliseconds(frameTimes.percentile(0.5)));
+      p99s[FRAME].push_back(inMilliseconds(frameTimes.percentile(0.99)));
+    }
+    std::vector < std::string > names;
+    for (PipelineStage::Id stage: STAGES) {
+      names.push_back(PipelineStage::name(stage));
+    }
+    names.push_back(FRAME);
+    std::map < std::string, Timing > measured;
+    for (const std::string & name: names) {
+      measured[name] = Timing {
+        medianOf(medians[name]), medianOf(p99s[name])
+      };
+    }
+
+    if (0 != commandlineArguments.count("write-baseline")) {
+      std::ofstream out(commandlineArguments["write-baseline"], std::ios::out | std::ios::trunc);
+      out << "# perf-gate baseline: " << frames.size() << " frames x " << PASSES << " passes, median of " << TRIALS << " trials" << std::endl;
+      out << "# mode: " << MODE << std::endl;
+      out << "# corpus: " << corpus << std::endl;
+      out << "stage;median_ms;p99_ms" << std::endl;
+      out << std::fixed << std::setprecision(4);
+      for (const std::string & name: names) {
+        out << name << ";" << measured[name].median << ";" << measured[name].p99 << std::endl;
+      }
+      out.flush();
+      if (!out.good()) {
+        std::cerr << argv[0] << ": Could not write '" << commandlineArguments["write-baseline"] << "'." << std::endl;
+        return retCode;
+      }
+      std::clog << argv[0] << ": Wrote the baseline for " << corpus << " with the " << MODE << " kernels to '" << commandlineArguments["write-baseline"] << "'." << std::endl;
+      retCode = 0;
+    } else {
+      // A stage regresses if its median or its 99th percentile grew by more than the tolerance and by at least MIN_DELTA.
+      auto regressed = [MIN_DELTA](double now, double before, double tolerance) {
+        return (now > before * (1.0 + tolerance)) && (now - before >= MIN_DELTA);
+      };
+      bool passed {
+        true
+      };
+      std::cout << "stage;median_ms;p99_ms;baseline_median_ms;baseline_p99_ms;result" << std::endl;
+      std::cout << std::fixed << std::setprecision(4);
+      for (const std::string & name: names) {
+        const Timing & now {
+          measured[name]
+        };
+        std::cout << name << ";" << now.median << ";" << now.p99 << ";";
+        if (0 == baseline.count(name)) {
+          std::cout << "-;-;new" << std::endl;
+          continue;
+        }
+        const Timing & before {
+          baseline[name]
+        };
+        const bool regression {
+          regressed(now.median, before.median, TOLERANCE) || regressed(now.p99, before.p99, P99_TOLERANCE)
+        };
+        passed = passed && !regression;
+        std::cout << before.median << ";" << before.p99 << ";" << (regression ? "regression" : "pass") << std::endl;
+      }
+
+      // Independent of the baseline, a frame must never take longer than the requirement allows.
+      if (measured[FRAME].p99 >= 150.0) {
+        std::cerr << argv[0] << ": The 99th percentile of a frame is over 150 ms." << std::endl;
+        passed = false;
+      }
+      retCode = passed ? 0 : 1;
+    }
+  }
+  return retCode;
+}
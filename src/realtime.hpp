@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef REALTIME_HPP
+#define REALTIME_HPP
+
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
+
+// Scheduling, core and memory settings that keep other processes, the
+// scheduler and page faults from delaying the frame loop.
+//
+// All of them need privileges that a process usually lacks: real-time policies
+// need CAP_SYS_NICE or an rtprio limit, and locking memory needs CAP_IPC_LOCK
+// or a large enough memlock limit. Every function returns false and says why
+// in error instead of failing, so the caller can go on without the setting.
+class Realtime {
+ public:
+  // Parse a list of cores such as "3", "0,2" or "0-3".
+  static bool parseCpus(const std::string &list, std::vector<int> &cpus) {
+    cpus.clear();
+    std::size_t begin{0};
+    while (begin < list.size()) {
+      const std::size_t end{std::min(list.find(',', begin), list.size())};
+      const std::string item{list.substr(begin, end - begin)};
+      int first{0};
+      int last{0};
+      char dash{0};
+      const int matched{std::sscanf(item.c_str(), "%d%c%d", &first, &dash, &last)};
+      if ((1 == matched) && (0 <= first)) {
+        cpus.push_back(first);
+      } else if ((3 == matched) && ('-' == dash) && (0 <= first) && (first <= last)) {
+        for (int cpu{first}; cpu <= last; cpu++) {
+          cpus.push_back(cpu);
+        }
+      } else {
+        return false;
+      }
+      begin = end + 1;
+    }
+    return !cpus.empty();
+  }
+
+  // Cores the calling thread may run on.
+  static std::vector<int> cpusOfThisThread() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (0 == ::pthread_getaffinity_np(::pthread_self(), sizeof(set), &set)) {
+      for (int cpu{0}; cpu < CPU_SETSIZE; cpu++) {
+        if (CPU_ISSET(cpu, &set)) {
+          cpus.push_back(cpu);
+        }
+      }
+    }
+    return cpus;
+  }
+
+  // Run the calling thread only on cpus; threads it starts afterwards inherit this.
+  static bool pinThisThread(const std::vector<int> &cpus, std::string &error) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+      if ((0 > cpu) || (CPU_SETSIZE <= cpu)) {
+        error = "core " + std::to_string(cpu) + " does not exist";
+        return false;
+      }
+      CPU_SET(cpu, &set);
+    }
+    const int result{::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set)};
+    if (0 != result) {
+      error = std::string{"pthread_setaffinity_np: "} + std::strerror(result);
+      return false;
+    }
+    return true;
+  }
+
+  // Run the calling thread with SCHED_FIFO at priority (1..99); it then only
+  // yields to threads of higher priority.
+  static bool setFifo(int priority, std::string &error) {
+    struct sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    param.sched_priority = priority;
+    const int result{::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &param)};
+    if (0 != result) {
+      error = std::string{"pthread_setschedparam: "} + std::strerror(result) + privilegeHint(result, "CAP_SYS_NICE or an rtprio limit in /etc/security/limits.conf");
+      return false;
+    }
+    return true;
+  }
+
+  // Reserve runtime of the CPU in every period for the calling thread with
+  // SCHED_DEADLINE. The kernel only admits such threads if they may run on all
+  // cores of their root domain, so the thread must not be pinned.
+  static bool setDeadline(std::chrono::microseconds runtime, std::chrono::microseconds period, std::string &error) {
+    // struct sched_attr of the kernel; glibc has no wrapper for sched_setattr
+    struct SchedAttr {
+      uint32_t size;
+      uint32_t schedPolicy;
+      uint64_t schedFlags;
+      int32_t schedNice;
+      uint32_t schedPriority;
+      uint64_t schedRuntime;
+      uint64_t schedDeadline;
+      uint64_t schedPeriod;
+    } attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.schedPolicy = SCHED_DEADLINE;
+    attr.schedRuntime = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(runtime).count());
+    attr.schedDeadline = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(period).count());
+    attr.schedPeriod = attr.schedDeadline;
+    if (0 != ::syscall(SYS_sched_setattr, 0, &attr, 0)) {
+      const int e{errno};
+      error = std::string{"sched_setattr: "} + std::strerror(e) + privilegeHint(e, "CAP_SYS_NICE, and no affinity to a subset of the cores");
+      if (EBUSY == e) {
+        error += " (the cores cannot admit this runtime per period)";
+      }
+      return false;
+    }
+    return true;
+  }
+
+  // Keep all pages of the process, current and future, in memory, and keep
+  // freed heap memory in the process so that it is not faulted in again.
+  // If the pages cannot be locked, the allocator keeps its defaults: an
+  // unlocked process that never returns memory would only grow.
+  static bool lockMemory(std::string &error) {
+    if (0 != ::mlockall(MCL_CURRENT | MCL_FUTURE)) {
+      const int e{errno};
+      // Over the memlock limit, mlockall fails with ENOMEM rather than EPERM
+      error = std::string{"mlockall: "} + std::strerror(e) + privilegeHint((ENOMEM == e) ? EPERM : e, "CAP_IPC_LOCK or a larger memlock limit (ulimit -l)");
+      return false;
+    }
+    ::mallopt(M_TRIM_THRESHOLD, -1);
+    ::mallopt(M_MMAP_MAX, 0);
+    return true;
+  }
+
+  // Touch bytes of the stack below the caller so that deep calls do not
+  // fault; not inlined, so the stack is released when it returns.
+  __attribute__((noinline)) static void prefaultStack(std::size_t bytes) {
+    // volatile keeps the compiler from removing the writes
+    volatile char *stack{static_cast<volatile char *>(::alloca(bytes))};
+    const std::size_t pageSize{static_cast<std::size_t>(::sysconf(_SC_PAGESIZE))};
+    for (std::size_t i{0}; i < bytes; i += pageSize) {
+      stack[i] = 0;
+    }
+  }
+
+ private:
+  static std::string privilegeHint(int error, const char *needs) {
+    return ((EPERM == error) || (EACCES == error)) ? std::string{" (needs "} + needs + ")" : std::string{};
+  }
+};
+
+#endif
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPECIALIZED_PIPELINE_HPP
+#define SPECIALIZED_PIPELINE_HPP
+
+#include "steering-config.hpp"
+
+#include <opencv2/core/core.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+// Segmentation kernels compiled for a fixed region size and cone colour. With
+// all extents known, the loops have constant trip counts and no bounds checks,
+// and the compiler can unroll and vectorize them.
+//
+// The kernels compute what ConeSegmentation computes with OpenCV for BGR(A)
+// regions in full quality: the colour conversion of cvtColor (COLOR_BGR2HSV,
+// 8 bit) fused with inRange, and the 5x5 GaussianBlur with BORDER_REFLECT_101.
+// The dilate and erode that follow there get a 1x1 kernel and copy the image,
+// so the kernels leave them out.
+namespace specialized {
+
+constexpr int BLUR_RADIUS{2}; // the 5x5 Gaussian the detection was tuned with
+constexpr int HSV_SHIFT{12};  // fixed-point bits of cvtColor's 8-bit HSV conversion
+
+// Cone colours on the track; the default HSV ranges of SteeringDetectorConfig.
+struct TrackColours {
+  struct Blue {
+    static constexpr HsvRange range() noexcept {
+      return HsvRange{102, 150, 88, 165, 43, 222};
+    }
+  };
+  struct Yellow {
+    static constexpr HsvRange range() noexcept {
+      return HsvRange{0, 42, 75, 221, 170, 255};
+    }
+  };
+};
+
+// Reciprocals of cvtColor's 8-bit HSV conversion, rounded the same way.
+struct HsvTables {
+  int sdiv[256];
+  int hdiv[256];
+
+  static const HsvTables &instance() noexcept {
+    static const HsvTables TABLES{};
+    return TABLES;
+  }
+
+ private:
+  HsvTables() noexcept {
+    sdiv[0] = 0;
+    hdiv[0] = 0;
+    for (int i{1}; i < 256; i++) {
+      sdiv[i] = static_cast<int>(std::lrint((255 << HSV_SHIFT) / (1.0 * i)));
+      hdiv[i] = static_cast<int>(std::lrint((180 << HSV_SHIFT) / (6.0 * i)));
+    }
+  }
+};
+
+// Mirror the BLUR_RADIUS outer rows and columns of a padded image as
+// BORDER_REFLECT_101 does.
+template <int Width, int Height>
+void reflectBorder(cv::Mat &padded) noexcept {
+  constexpr int B{BLUR_RADIUS};
+  for (int y{B}; y < Height + B; y++) {
+    uint8_t *row{padded.ptr<uint8_t>(y)};
+    for (int k{1}; k <= B; k++) {
+      row[B - k] = row[B + k];
+      row[B + Width - 1 + k] = row[B + Width - 1 - k];
+    }
+  }
+  for (int k{1}; k <= B; k++) {
+    std::copy_n(padded.ptr<uint8_t>(B + k), Width + 2 * B, padded.ptr<uint8_t>(B - k));
+    std::copy_n(padded.ptr<uint8_t>(B + Height - 1 - k), Width + 2 * B, padded.ptr<uint8_t>(B + Height - 1 + k));
+  }
+}
+
+// cvtColor(COLOR_BGR2HSV) and inRange for Colour in one pass; the mask is
+// written into the centre of padded, which is surrounded by its reflection.
+template <int Width, int Height, int Channels, typename Colour>
+void threshold(const cv::Mat &region, cv::Mat &padded) {
+  static_assert((3 == Channels) || (4 == Channels), "Regions must be BGR or BGRA");
+  constexpr HsvRange RANGE{Colour::range()};
+  constexpr int B{BLUR_RADIUS};
+  const HsvTables &tables{HsvTables::instance()};
+  padded.create(Height + 2 * B, Width + 2 * B, CV_8UC1);
+  for (int y{0}; y < Height; y++) {
+    const uint8_t *src{region.ptr<uint8_t>(y)};
+    uint8_t *dst{padded.ptr<uint8_t>(y + B) + B};
+    for (int x{0}; x < Width; x++) {
+      const int b{src[x * Channels]};
+      const int g{src[x * Channels + 1]};
+      const int r{src[x * Channels + 2]};
+      const int v{std::max(b, std::max(g, r))};
+      const int diff{v - std::min(b, std::min(g, r))};
+      const int vr{(v == r) ? -1 : 0};
+      const int vg{(v == g) ? -1 : 0};
+      const int s{(diff * tables.sdiv[v] + (1 << (HSV_SHIFT - 1))) >> HSV_SHIFT};
+      int h{(vr & (g - b)) + (~vr & ((vg & (b - r + 2 * diff)) + (~vg & (r - g + 4 * diff))))};
+      h = (h * tables.hdiv[diff] + (1 << (HSV_SHIFT - 1))) >> HSV_SHIFT;
+      h += (h < 0) ? 180 : 0;
+      // & rather than && so that there are no branches to mispredict
+      const int inside{(RANGE.minHue <= h) & (h <= RANGE.maxHue) & (RANGE.minSat <= s) & (s <= RANGE.maxSat) & (RANGE.minValue <= v) &
+                        (v <= RANGE.maxValue)};
+      dst[x] = static_cast<uint8_t>(255 * inside);
+    }
+  }
+  reflectBorder<Width, Height>(padded);
+}
+
+// Intermediate image of filter for one region size.
+template <int Width, int Height>
+struct FilterScratch {
+  uint16_t rows[Height + 2 * BLUR_RADIUS][Width];
+};
+
+// GaussianBlur 5x5 from the padded output of threshold into mask. The row
+// sums are kept in scratch, which grows on the first call for a size.
+template <int Width, int Height>
+void filter(const cv::Mat &padded, cv::Mat &mask, std::vector<uint8_t> &scratch) {
+  constexpr int B{BLUR_RADIUS};
+  using Scratch = FilterScratch<Width, Height>;
+  if (scratch.size() < sizeof(Scratch)) {
+    scratch.resize(sizeof(Scratch));
+  }
+  // Only an array of integers, so this initializes nothing
+  auto &rows = (new (scratch.data()) Scratch)->rows;
+
+  // Binomial weights 1 4 6 4 1 per direction; GaussianBlur's 8-bit fixed-point
+  // filter rounds the sum of both passes once, divided by 256
+  for (int y{0}; y < Height + 2 * B; y++) {
+    const uint8_t *in{padded.ptr<uint8_t>(y)};
+    for (int x{0}; x < Width; x++) {
+      rows[y][x] = static_cast<uint16_t>(in[x] + 4 * in[x + 1] + 6 * in[x + 2] + 4 * in[x + 3] + in[x + 4]);
+    }
+  }
+  mask.create(Height, Width, CV_8UC1);
+  for (int y{0}; y < Height; y++) {
+    uint8_t *out{mask.ptr<uint8_t>(y)};
+    for (int x{0}; x < Width; x++) {
+      const uint32_t sum{rows[y][x] + 4u * rows[y + 1][x] + 6u * rows[y + 2][x] + 4u * rows[y + 3][x] + rows[y + 4][x]};
+      out[x] = static_cast<uint8_t>((sum + 128u) >> 8);
+    }
+  }
+}
+
+}
+
+// Kernels for regions of one size in one colour.
+struct SpecializedKernels {
+  int width;
+  int height;
+  int channels;
+  HsvRange range;
+  void (*threshold)(const cv::Mat &region, cv::Mat &padded);
+  void (*filter)(const cv::Mat &padded, cv::Mat &mask, std::vector<uint8_t> &scratch);
+};
+
+// Kernels compiled for the camera modes in use; every other combination of
+// region size, colour and number of channels takes the generic OpenCV path.
+class PipelineRegistry {
+ public:
+  // Kernels for an 8-bit region in range, or nullptr; the kernels read the
+  // pixels as bytes, so they must not get a region of any other depth.
+  static const SpecializedKernels *find(const cv::Mat &region, const HsvRange &range) noexcept {
+    if (CV_8U != region.depth()) {
+      return nullptr;
+    }
+    for (const SpecializedKernels &kernels : all()) {
+      if ((kernels.width == region.cols) && (kernels.height == region.rows) && (kernels.channels == region.channels()) && same(kernels.range, range)) {
+        return &kernels;
+      }
+    }
+    return nullptr;
+  }
+
+  static const std::vector<SpecializedKernels> &all() {
+    static const std::vector<SpecializedKernels> KERNELS{registry()};
+    return KERNELS;
+  }
+
+ private:
+  static bool same(const HsvRange &a, const HsvRange &b) noexcept {
+    return (a.minHue == b.minHue) && (a.maxHue == b.maxHue) && (a.minSat == b.minSat) && (a.maxSat == b.maxSat) && (a.minValue == b.minValue) &&
+           (a.maxValue == b.maxValue);
+  }
+
+  template <int Width, int Height>
+  static void add(std::vector<SpecializedKernels> &kernels) {
+    using specialized::TrackColours;
+    kernels.push_back(kernelsFor<Width, Height, 3, TrackColours::Blue>());
+    kernels.push_back(kernelsFor<Width, Height, 3, TrackColours::Yellow>());
+    kernels.push_back(kernelsFor<Width, Height, 4, TrackColours::Blue>());
+    kernels.push_back(kernelsFor<Width, Height, 4, TrackColours::Yellow>());
+  }
+
+  template <int Width, int Height, int Channels, typename Colour>
+  static SpecializedKernels kernelsFor() noexcept {
+    return SpecializedKernels{Width, Height, Channels, Colour::range(), &specialized::threshold<Width, Height, Channels, Colour>,
+                              &specialized::filter<Width, Height>};
+  }
+
+  // Regions of interest right and centre of the default configuration for
+  // 640x480. SYNTHETIC_CAMERA_MODES adds them as scaled by
+  // SyntheticFrames::config for 320x240 and 1280x720, which only perf-gate,
+  // the benchmarks and the tests measure with.
+  static std::vector<SpecializedKernels> registry() {
+    std::vector<SpecializedKernels> kernels;
+    add<150, 125>(kernels);
+    add<230, 115>(kernels);
+#ifdef SYNTHETIC_CAMERA_MODES
+    add<75, 62>(kernels);
+    add<115, 57>(kernels);
+    add<300, 187>(kernels);
+    add<460, 172>(kernels);
+#endif
+    return kernels;
+  }
+};
+
+#endif
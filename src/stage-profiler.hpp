@@ -0,0 +1,280 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STAGE_PROFILER_HPP
+#define STAGE_PROFILER_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#ifdef STAGE_PROFILING
+#include "chrome-trace.hpp"
+#include "latency-histogram.hpp"
+#include "perf-counters.hpp"
+
+#include <algorithm>
+#include <iomanip>
+#include <memory>
+#endif
+
+// Stages of the frame loop of the microservice.
+struct PipelineStage {
+  enum Id : uint32_t {
+    WAIT = 0,       // waiting for the next frame
+    LOCK_AND_CLONE, // copying the frame out of the shared memory
+    CVT_COLOR,
+    IN_RANGE,
+    BLUR_AND_MORPH,
+    FIND_CONTOURS,
+    STEERING, // contour areas and the steering logic
+    PUT_TEXT,
+    STDOUT,
+    NUMBER_OF_STAGES,
+  };
+
+  static const char *name(Id stage) noexcept {
+    static const char *NAMES[NUMBER_OF_STAGES]{"wait", "lock+clone", "cvtColor", "inRange", "blur/morph", "findContours", "steering", "putText", "stdout"};
+    return (stage < NUMBER_OF_STAGES) ? NAMES[stage] : "?";
+  }
+};
+
+#ifdef STAGE_PROFILING
+
+// Time spent per stage of the frame loop, reported as percentiles at a fixed
+// interval. Only the frame loop thread may use an instance.
+//
+// Stages may be nested (e.g. the segmentation inside the steering); a stage is
+// only charged for the time not spent in the stages nested in it, so the
+// stages of a frame add up to the time of the frame. If the Tracer was
+// started, every stage is also recorded as a span. With enableCounters(), the
+// hardware counters of the thread are attributed to the stages the same way;
+// reading them costs two system calls per stage, which nested stages add to
+// the time of their parent.
+class StageProfiler {
+ public:
+  static constexpr bool ENABLED{true};
+
+ public:
+  explicit StageProfiler(std::chrono::seconds interval) noexcept
+      : m_interval{interval}
+      , m_lastReport{std::chrono::steady_clock::now()} {}
+
+  StageProfiler(const StageProfiler &) = delete;
+  StageProfiler &operator=(const StageProfiler &) = delete;
+
+  // Durations per stage since the last report or reset().
+  const LatencyHistogram &histogram(PipelineStage::Id stage) const noexcept {
+    return m_histograms[stage];
+  }
+
+  void reset() noexcept {
+    for (uint32_t i{0}; i < PipelineStage::NUMBER_OF_STAGES; i++) {
+      m_histograms[i].reset();
+      m_counts[i] = PerfCounters::Values{};
+      m_pixels[i] = 0;
+    }
+  }
+
+  // Attribute hardware counters to the stages; must be called from the thread
+  // that runs the stages. Returns false with the reason in error otherwise.
+  bool enableCounters(std::string &error) {
+    m_counters.reset(new PerfCounters);
+    if (!m_counters->valid()) {
+      error = m_counters->error();
+      m_counters.reset();
+    }
+    return nullptr != m_counters;
+  }
+
+  // Print p50/p90/p99/max per stage if the interval has passed since the last
+  // report, and start the next interval.
+  void reportIfDue(std::ostream &out) {
+    const auto now = std::chrono::steady_clock::now();
+    if (now - m_lastReport < m_interval) {
+      return;
+    }
+    m_lastReport = now;
+    out << "stage;count;p50_ms;p90_ms;p99_ms;max_ms" << std::endl;
+    for (uint32_t i{0}; i < PipelineStage::NUMBER_OF_STAGES; i++) {
+      LatencyHistogram &histogram{m_histograms[i]};
+      out << PipelineStage::name(static_cast<PipelineStage::Id>(i)) << ";" << histogram.count();
+      writePercentilesInMilliseconds(out, histogram);
+      out << std::endl;
+      histogram.reset();
+    }
+    if (nullptr != m_counters) {
+      reportCounters(out);
+    }
+  }
+
+ private:
+  friend class StageTimer;
+
+  static constexpr uint32_t MAX_DEPTH{8};
+
+  void enter() noexcept {
+    if (m_depth < MAX_DEPTH) {
+      m_nested[m_depth] = 0;
+      if (nullptr != m_counters) {
+        m_nestedCounts[m_depth] = PerfCounters::Values{};
+        m_counters->read(m_countsAtEnter[m_depth]);
+      }
+    }
+    m_depth++;
+  }
+
+  void leave(PipelineStage::Id stage, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end, uint64_t pixels) noexcept {
+    const uint64_t nanoseconds{static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count())};
+    if (m_tracer.enabled()) {
+      m_tracer.record(PipelineStage::name(stage), begin, end);
+    }
+    m_depth--;
+    const uint64_t nested{(m_depth < MAX_DEPTH) ? m_nested[m_depth] : 0};
+    m_histograms[stage].record((nanoseconds > nested) ? nanoseconds - nested : 0);
+    if ((0 < m_depth) && (m_depth - 1 < MAX_DEPTH)) {
+      m_nested[m_depth - 1] += nanoseconds;
+    }
+    if ((nullptr != m_counters) && (m_depth < MAX_DEPTH)) {
+      PerfCounters::Values counts;
+      m_counters->read(counts);
+      for (uint32_t c{0}; c < PerfCounters::NUMBER_OF_COUNTERS; c++) {
+        const uint64_t total{counts.value[c] - m_countsAtEnter[m_depth].value[c]};
+        const uint64_t own{total - std::min(total, m_nestedCounts[m_depth].value[c])};
+        m_counts[stage].value[c] += own;
+        if (0 < m_depth) {
+          m_nestedCounts[m_depth - 1].value[c] += total;
+        }
+      }
+      m_pixels[stage] += pixels;
+    }
+  }
+
+  // Print the counts per stage since the last report, also per pixel for the
+  // stages that work on pixels.
+  void reportCounters(std::ostream &out) {
+    out << "stage;cycles;instructions;ipc;cache_misses;branch_misses;pixels;cycles_per_pixel;cache_misses_per_pixel" << std::endl;
+    const std::streamsize precision{out.precision()};
+    out << std::fixed << std::setprecision(3);
+    for (uint32_t i{0}; i < PipelineStage::NUMBER_OF_STAGES; i++) {
+      const PerfCounters::Values &counts{m_counts[i]};
+      out << PipelineStage::name(static_cast<PipelineStage::Id>(i));
+      for (uint32_t c{0}; c < PerfCounters::NUMBER_OF_COUNTERS; c++) {
+        if (PerfCounters::CACHE_MISSES == c) {
+          writeRatio(out, counts.value[PerfCounters::INSTRUCTIONS], counts.value[PerfCounters::CYCLES], m_counters->has(PerfCounters::INSTRUCTIONS));
+        }
+        out << ";";
+        if (m_counters->has(static_cast<PerfCounters::Counter>(c))) {
+          out << counts.value[c];
+        } else {
+          out << "-";
+        }
+      }
+      out << ";" << m_pixels[i];
+      writeRatio(out, counts.value[PerfCounters::CYCLES], m_pixels[i], true);
+      writeRatio(out, counts.value[PerfCounters::CACHE_MISSES], m_pixels[i], m_counters->has(PerfCounters::CACHE_MISSES));
+      out << std::endl;
+      m_counts[i] = PerfCounters::Values{};
+      m_pixels[i] = 0;
+    }
+    out << std::defaultfloat << std::setprecision(precision);
+  }
+
+  static void writeRatio(std::ostream &out, uint64_t numerator, uint64_t denominator, bool available) {
+    out << ";";
+    if (available && (0 < denominator)) {
+      out << static_cast<double>(numerator) / static_cast<double>(denominator);
+    } else {
+      out << "-";
+    }
+  }
+
+ private:
+  std::chrono::steady_clock::duration m_interval;
+  std::chrono::steady_clock::time_point m_lastReport;
+
+  Tracer &m_tracer{Tracer::instance()};
+  LatencyHistogram m_histograms[PipelineStage::NUMBER_OF_STAGES]{};
+  uint32_t m_depth{0};
+  uint64_t m_nested[MAX_DEPTH] = {};
+
+  std::unique_ptr<PerfCounters> m_counters{};
+  PerfCounters::Values m_countsAtEnter[MAX_DEPTH]{};
+  PerfCounters::Values m_nestedCounts[MAX_DEPTH]{};
+  PerfCounters::Values m_counts[PipelineStage::NUMBER_OF_STAGES]{};
+  uint64_t m_pixels[PipelineStage::NUMBER_OF_STAGES] = {};
+};
+
+// Charges the time from its construction to its destruction to a stage; does
+// nothing without a profiler. Stages that work on pixels pass their number to
+// get the counters per pixel.
+class StageTimer {
+ public:
+  StageTimer(StageProfiler *profiler, PipelineStage::Id stage, uint64_t pixels = 0) noexcept
+      : m_profiler{profiler}
+      , m_stage{stage}
+      , m_pixels{pixels}
+      , m_start{} {
+    if (nullptr != m_profiler) {
+      m_profiler->enter();
+      m_start = std::chrono::steady_clock::now();
+    }
+  }
+
+  ~StageTimer() {
+    if (nullptr != m_profiler) {
+      m_profiler->leave(m_stage, m_start, std::chrono::steady_clock::now(), m_pixels);
+    }
+  }
+
+  StageTimer(const StageTimer &) = delete;
+  StageTimer &operator=(const StageTimer &) = delete;
+
+ private:
+  StageProfiler *m_profiler;
+  PipelineStage::Id m_stage;
+  uint64_t m_pixels;
+  std::chrono::steady_clock::time_point m_start;
+};
+
+#else
+
+// Built without STAGE_PROFILING: the same interface, compiled to nothing.
+class StageProfiler {
+ public:
+  static constexpr bool ENABLED{false};
+
+ public:
+  explicit StageProfiler(std::chrono::seconds) noexcept {}
+
+  bool enableCounters(std::string &error) {
+    error = "built without STAGE_PROFILING";
+    return false;
+  }
+
+  void reportIfDue(std::ostream &) noexcept {}
+};
+
+class StageTimer {
+ public:
+  StageTimer(StageProfiler *, PipelineStage::Id, uint64_t = 0) noexcept {}
+};
+
+#endif
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STEERING_CONFIG_HPP
+#define STEERING_CONFIG_HPP
+
+#include <opencv2/core/core.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+// Lower and upper HSV bounds of a cone colour.
+struct HsvRange {
+  int minHue;
+  int maxHue;
+  int minSat;
+  int maxSat;
+  int minValue;
+  int maxValue;
+};
+
+// Tunable parameters of the cone detection; the defaults are the values used on the track.
+struct SteeringDetectorConfig {
+  HsvRange blue{102, 150, 88, 165, 43, 222};
+  HsvRange yellow{0, 42, 75, 221, 170, 255};
+
+  int frameSampleSize{5};  // initial number of frames used to determine direction
+  int identifiedShape{60}; // pixel size used to determine cones
+
+  float steeringMax{0.3f};
+  float steeringMin{-0.3f};
+  float carTurnR{0.025f};
+  float carTurnL{-0.025f};
+
+  cv::Rect regionOfInterestRight{415, 265, 150, 125}; // used on the first frames to find the car direction
+  cv::Rect regionOfInterestCentre{200, 245, 230, 115};
+
+  // Bounding box of all pixels the detection looks at.
+  cv::Rect boundingRegionOfInterest() const noexcept {
+    const cv::Rect &a{regionOfInterestRight};
+    const cv::Rect &b{regionOfInterestCentre};
+    const int left{std::min(a.x, b.x)};
+    const int top{std::min(a.y, b.y)};
+    return cv::Rect(left, top, std::max(a.x + a.width, b.x + b.width) - left, std::max(a.y + a.height, b.y + b.height) - top);
+  }
+
+  // Same detection on frames cropped to a region starting at origin.
+  SteeringDetectorConfig croppedTo(const cv::Point &origin) const noexcept {
+    SteeringDetectorConfig cropped{*this};
+    cropped.regionOfInterestRight.x -= origin.x;
+    cropped.regionOfInterestRight.y -= origin.y;
+    cropped.regionOfInterestCentre.x -= origin.x;
+    cropped.regionOfInterestCentre.y -= origin.y;
+    return cropped;
+  }
+};
+
+// Regions and colours in which the cones are searched for.
+enum ConeChannel : uint32_t {
+  YELLOW_RIGHT = 0, // only on the first frames to find the car direction
+  BLUE_CENTRE = 1,
+  YELLOW_CENTRE = 2,
+  NUMBER_OF_CONE_CHANNELS = 3,
+};
+
+#endif
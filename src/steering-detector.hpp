@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STEERING_DETECTOR_HPP
+#define STEERING_DETECTOR_HPP
+
+#include "blob-extractor.hpp"
+#include "cone-segmentation.hpp"
+#include "stage-profiler.hpp"
+#include "steering-config.hpp"
+#include "steering-policy.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cstddef>
+
+// Contour images of the last processed frame; only drawn when requested as they
+// do not influence the steering wheel angle. An image stays empty if its colour
+// was not searched for in that frame.
+struct SteeringDetectorContours {
+  cv::Mat blue{};
+  cv::Mat yellow{};
+};
+
+// Turns the blobs found in a frame into a steering wheel angle: the first
+// frames find the direction of the car, the others steer away from the cones.
+//
+// Only the blob areas are used, so the controller runs on live segmentation
+// results as well as on features cached from an earlier run.
+class SteeringController {
+ public:
+  explicit SteeringController(const SteeringDetectorConfig &config = SteeringDetectorConfig{}) noexcept
+      : m_config{config}
+      , m_direction{config}
+      , m_policy{config} {}
+
+  // Advance by one frame; areasOf(channel) must return the BlobAreas of the
+  // channel in this frame and is only called for the channels that are needed.
+  template <typename AreasOf>
+  float update(AreasOf &&areasOf) {
+    if (m_direction.next()) {
+      m_direction.sample(areasOf(YELLOW_RIGHT));
+      return m_policy.steeringWheelAngle();
+    }
+    return m_policy.update(m_direction.carDirection(), areasOf);
+  }
+
+  const SteeringDetectorConfig &config() const noexcept {
+    return m_config;
+  }
+
+  int carDirection() const noexcept {
+    return m_direction.carDirection();
+  }
+
+  int frameCounter() const noexcept {
+    return m_direction.frameCounter();
+  }
+
+ private:
+  SteeringDetectorConfig m_config;
+  DirectionEstimator m_direction;
+  SteeringPolicy m_policy;
+};
+
+// Computes the steering wheel angle from a sequence of frames by following the
+// blue and yellow cones in front of the car.
+//
+// The result of a frame depends only on the frames processed before it, never on
+// wall time; the live microservice and the offline replay share this class so
+// that their outputs are identical for the same frames.
+class SteeringDetector {
+ public:
+  explicit SteeringDetector(const SteeringDetectorConfig &config = SteeringDetectorConfig{}) noexcept
+      : m_controller{config} {}
+
+  // Process the next frame (BGR or BGRA) and return its steering wheel angle.
+  float process(const cv::Mat &img, SteeringDetectorContours *contours = nullptr) {
+    return processFrame(img, false, contours);
+  }
+
+  // Same as process(...) for a frame that was converted to HSV already; the
+  // conversion does not depend on the configuration, so a parameter sweep
+  // converts every frame only once.
+  float processHsv(const cv::Mat &hsv, SteeringDetectorContours *contours = nullptr) {
+    return processFrame(hsv, true, contours);
+  }
+
+  int carDirection() const noexcept {
+    return m_controller.carDirection();
+  }
+
+  int frameCounter() const noexcept {
+    return m_controller.frameCounter();
+  }
+
+  // Charge the time per frame to profiler; nullptr to stop.
+  void setProfiler(StageProfiler *profiler) noexcept {
+    m_segmentation.setProfiler(profiler);
+  }
+
+  // Allocate the buffers of the detection for frames of size before the first
+  // frame arrives; the steering state does not change.
+  void prefault(const cv::Size &size) {
+    const cv::Mat blank = cv::Mat::zeros(size, CV_8UC4);
+    const SteeringDetectorConfig &config{m_controller.config()};
+    m_segmentation.detect(blank(config.regionOfInterestRight), config.yellow, false);
+    m_segmentation.detect(blank(config.regionOfInterestCentre), config.blue, false);
+    m_blobs.reserve(64);
+  }
+
+  // Use the segmentation kernels compiled for the regions of interest where
+  // there are any (the default); the steering wheel angles are the same.
+  void setSpecialized(bool specialized) noexcept {
+    m_segmentation.setSpecialized(specialized);
+  }
+
+  // Detect the cones of the following frames with these shortcuts. The
+  // steering wheel angles then also depend on when the quality was changed,
+  // so the offline replay always uses the full detection.
+  void setQuality(const ProcessingQuality &quality) noexcept {
+    m_segmentation.setQuality(quality);
+  }
+
+ private:
+  float processFrame(const cv::Mat &img, bool imgIsHsv, SteeringDetectorContours *contours) {
+    StageTimer timer{m_segmentation.profiler(), PipelineStage::STEERING};
+    if (nullptr != contours) {
+      contours->blue.release();
+      contours->yellow.release();
+    }
+
+    const SteeringDetectorConfig &config{m_controller.config()};
+    // Areas at half resolution are compared with the thresholds for full frames
+    const double areaScale{m_segmentation.quality().halfResolution ? 4.0 : 1.0};
+    return m_controller.update([&, areaScale](ConeChannel channel) {
+      const bool right{YELLOW_RIGHT == channel};
+      const auto &found = m_segmentation.detect(img(right ? config.regionOfInterestRight : config.regionOfInterestCentre),
+                                                (BLUE_CENTRE == channel) ? config.blue : config.yellow, imgIsHsv);
+      const BlobAreas areas{m_blobs.extract(found, areaScale)};
+
+      // Draw the cones in the centre if their contour images are shown
+      if (!right && (nullptr != contours)) {
+        cv::Mat &contourImage{(BLUE_CENTRE == channel) ? contours->blue : contours->yellow};
+        contourImage = cv::Mat::zeros(m_segmentation.size().height, m_segmentation.size().width, CV_8UC3);
+        for (std::size_t i{0}; i < found.size(); i++) {
+          if (areas.first[i] > config.identifiedShape) {
+            cv::drawContours(contourImage, found, static_cast<int>(i), cv::Scalar(255, 255, 0), -1, 8, m_segmentation.hierarchy());
+          }
+        }
+      }
+      return areas;
+    });
+  }
+
+ private:
+  SteeringController m_controller;
+  ConeSegmentation m_segmentation{};
+  BlobExtractor m_blobs{};
+};
+
+#endif
@@ -0,0 +1,154 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STEERING_EVALUATION_HPP
+#define STEERING_EVALUATION_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Scores computed steering wheel angles against the original ones with the
+// acceptance rules from the README:
+//   - a frame is correct if the angle is within +/- 50% of the original angle,
+//   - or within +/- 0.05 if the original angle is 0,
+//   - more than 30% of all frames must be correct,
+//   - processing a frame must take less than 150 ms.
+class SteeringEvaluation {
+ public:
+  static constexpr float RELATIVE_TOLERANCE{0.5f};
+  static constexpr float TOLERANCE_AT_ZERO{0.05f};
+  static constexpr double REQUIRED_RATIO{0.3};
+  static constexpr int64_t BUDGET_IN_MICROSECONDS{150 * 1000};
+
+  // keepProcessingTimes: store every frame's processing time for
+  // processingTimePercentile(...); without, memory does not grow with the
+  // number of frames, as needed for the many configurations of a sweep.
+  explicit SteeringEvaluation(bool keepProcessingTimes = true) noexcept
+      : m_keepProcessingTimes{keepProcessingTimes} {}
+
+  static bool isCorrect(float steeringWheelAngle, float groundSteering) noexcept {
+    if (FP_ZERO == std::fpclassify(groundSteering)) {
+      return std::fabs(steeringWheelAngle) <= TOLERANCE_AT_ZERO;
+    }
+    return std::fabs(steeringWheelAngle - groundSteering) <= RELATIVE_TOLERANCE * std::fabs(groundSteering);
+  }
+
+ public:
+  void add(float steeringWheelAngle, float groundSteering, int64_t processingTimeInMicroseconds) {
+    const bool correct{isCorrect(steeringWheelAngle, groundSteering)};
+    m_frames++;
+    m_correctFrames += correct ? 1 : 0;
+    if (FP_ZERO == std::fpclassify(groundSteering)) {
+      m_framesAtZero++;
+      m_correctFramesAtZero += correct ? 1 : 0;
+    }
+    addProcessingTime(processingTimeInMicroseconds);
+  }
+
+  // Account for a frame that has no original angle to compare with yet.
+  void addUnscored(int64_t processingTimeInMicroseconds) {
+    m_unscoredFrames++;
+    addProcessingTime(processingTimeInMicroseconds);
+  }
+
+  void merge(const SteeringEvaluation &other) {
+    m_frames += other.m_frames;
+    m_correctFrames += other.m_correctFrames;
+    m_framesAtZero += other.m_framesAtZero;
+    m_correctFramesAtZero += other.m_correctFramesAtZero;
+    m_unscoredFrames += other.m_unscoredFrames;
+    m_maxProcessingTime = std::max(m_maxProcessingTime, other.m_maxProcessingTime);
+    m_framesOverBudget += other.m_framesOverBudget;
+    if (m_keepProcessingTimes) {
+      m_processingTimes.insert(m_processingTimes.end(), other.m_processingTimes.begin(), other.m_processingTimes.end());
+    }
+  }
+
+  uint64_t frames() const noexcept {
+    return m_frames;
+  }
+
+  uint64_t correctFrames() const noexcept {
+    return m_correctFrames;
+  }
+
+  uint64_t framesAtZero() const noexcept {
+    return m_framesAtZero;
+  }
+
+  uint64_t correctFramesAtZero() const noexcept {
+    return m_correctFramesAtZero;
+  }
+
+  uint64_t unscoredFrames() const noexcept {
+    return m_unscoredFrames;
+  }
+
+  // Share of correct frames in [0, 1].
+  double ratio() const noexcept {
+    return (0 == m_frames) ? 0.0 : static_cast<double>(m_correctFrames) / static_cast<double>(m_frames);
+  }
+
+  bool accepted() const noexcept {
+    return ratio() > REQUIRED_RATIO;
+  }
+
+  // Processing time in microseconds below which the given share of frames in
+  // [0, 1] stays; 0 if the processing times are not kept.
+  int64_t processingTimePercentile(double share) const {
+    if (m_processingTimes.empty()) {
+      return 0;
+    }
+    std::vector<int64_t> times{m_processingTimes};
+    const std::size_t last{times.size() - 1};
+    const std::size_t n{std::min(last, static_cast<std::size_t>(share * static_cast<double>(times.size())))};
+    std::nth_element(times.begin(), times.begin() + static_cast<std::ptrdiff_t>(n), times.end());
+    return times[n];
+  }
+
+  int64_t maxProcessingTime() const noexcept {
+    return m_maxProcessingTime;
+  }
+
+  uint64_t framesOverBudget() const noexcept {
+    return m_framesOverBudget;
+  }
+
+ private:
+  void addProcessingTime(int64_t processingTimeInMicroseconds) {
+    m_maxProcessingTime = std::max(m_maxProcessingTime, processingTimeInMicroseconds);
+    m_framesOverBudget += (processingTimeInMicroseconds >= BUDGET_IN_MICROSECONDS) ? 1 : 0;
+    if (m_keepProcessingTimes) {
+      m_processingTimes.push_back(processingTimeInMicroseconds);
+    }
+  }
+
+ private:
+  bool m_keepProcessingTimes{true};
+  uint64_t m_frames{0};
+  uint64_t m_correctFrames{0};
+  uint64_t m_framesAtZero{0};
+  uint64_t m_correctFramesAtZero{0};
+  uint64_t m_unscoredFrames{0};
+  int64_t m_maxProcessingTime{0};
+  uint64_t m_framesOverBudget{0};
+  std::vector<int64_t> m_processingTimes{};
+};
+
+#endif
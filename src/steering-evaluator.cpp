@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Include the single-file, header-only middleware libcluon to create high-performance microservices
+#include "cluon-complete.hpp"
+
+#include "cluon-complete.cpp"
+
+// Include the OpenDLV Standard Message Set that contains messages that are usually exchanged for automotive or robotic applications
+#include "opendlv-standard-message-set.hpp"
+
+// Include the cone detection, the offline replay of recordings and the acceptance rules from the README
+#include "steering-detector.hpp"
+#include "offline-replay.hpp"
+#include "steering-evaluation.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// Result of one recording.
+struct Result {
+  bool replayed {
+    false
+  };
+  SteeringEvaluation evaluation {};
+};
+
+static Result evaluate(const std::string & recFile) {
+  Result result;
+  SteeringDetector detector;
+  OfflineReplay replay {
+    recFile, OfflineReplay::framesFileFor(recFile)
+  };
+  result.replayed = replay.run([ & detector, & replay, & result](const cv::Mat & img, int64_t, const opendlv::proxy::GroundSteeringRequest & gsr) {
+    const auto start = std::chrono::steady_clock::now();
+    const float steeringWheelAngle {
+      detector.process(img)
+    };
+    const int64_t processingTime {
+      std::chrono::duration_cast < std::chrono::microseconds > (std::chrono::steady_clock::now() - start).count()
+    };
+
+    // Frames before the first GroundSteeringRequest have nothing to be compared with.
+    if (0 < replay.statistics().groundSteeringRequests) {
+      result.evaluation.add(steeringWheelAngle, gsr.groundSteering(), processingTime);
+    } else {
+      result.evaluation.addUnscored(processingTime);
+    }
+  });
+  return result;
+}
+
+static void print(const std::string & name, const SteeringEvaluation & evaluation) {
+  std::cout << name << ";"
+    << evaluation.frames() << ";"
+    << evaluation.correctFrames() << ";"
+    << std::fixed << std::setprecision(1) << 100.0 * evaluation.ratio() << ";"
+    << evaluation.framesAtZero() << ";"
+    << evaluation.correctFramesAtZero() << ";"
+    << std::setprecision(3)
+    << static_cast < double > (evaluation.processingTimePercentile(0.5)) / 1000.0 << ";"
+    << static_cast < double > (evaluation.processingTimePercentile(0.9)) / 1000.0 << ";"
+    << static_cast < double > (evaluation.processingTimePercentile(0.99)) / 1000.0 << ";"
+    << static_cast < double > (evaluation.maxProcessingTime()) / 1000.0 << ";"
+    << evaluation.framesOverBudget() << ";"
+    << (evaluation.accepted() ? "pass" : "fail") << std::endl;
+}
+
+int32_t main(int32_t argc, char ** argv) {
+  int32_t retCode {
+    1
+  };
+  auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  if (0 == commandlineArguments.count("rec")) {
+    std::cerr << argv[0] << " scores the steering wheel angles for many recordings against the original ones." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --rec=<recording>[,<recording>...] [--threads=<n>]" << std::endl;
+    std::cerr << "         --rec:     comma-separated .rec files with opendlv.proxy.GroundSteeringRequest; the frames are read" << std::endl;
+    std::cerr << "                    from <recording>.frames (see frame-capture) if present, or from raw BGRA ImageReadings" << std::endl;
+    std::cerr << "         --threads: number of recordings evaluated at the same time; default: number of cores" << std::endl;
+    std::cerr << "Example: " << argv[0] << " --rec=track1.rec,track2.rec" << std::endl;
+  } else {
+    std::vector < std::string > recFiles;
+    {
+      std::stringstream sstr {
+        commandlineArguments["rec"]
+      };
+      std::string recFile;
+      while (std::getline(sstr, recFile, ',')) {
+        if (!recFile.empty()) {
+          recFiles.push_back(recFile);
+        }
+      }
+    }
+
+    const uint32_t THREADS {
+      (0 != commandlineArguments.count("threads")) ? static_cast < uint32_t > (std::stoi(commandlineArguments["threads"])) : std::max(1u, std::thread::hardware_concurrency())
+    };
+    // The recordings are processed in parallel already; OpenCV's own threads would only compete for the same cores.
+    if (1 < THREADS) {
+      cv::setNumThreads(1);
+    }
+
+    // Each worker takes the next recording that is not evaluated yet.
+    std::vector < Result > results(recFiles.size());
+    std::atomic < std::size_t > nextRecFile {
+      0
+    };
+    std::vector < std::thread > workers;
+    for (uint32_t i = 0; i < std::min < std::size_t > (THREADS, recFiles.size()); i++) {
+      workers.emplace_back([ & recFiles, & results, & nextRecFile]() {
+        for (std::size_t j = nextRecFile++; j < recFiles.size(); j = nextRecFile++) {
+          results[j] = evaluate(recFiles[j]);
+        }
+      });
+    }
+    for (auto & worker: workers) {
+      worker.join();
+    }
+
+    std::cout << "recording;frames;correct;correct_percent;frames_at_zero;correct_at_zero;p50_ms;p90_ms;p99_ms;max_ms;over_150_ms;result" << std::endl;
+    SteeringEvaluation all;
+    bool allReplayed {
+      true
+    };
+    for (std::size_t i = 0; i < recFiles.size(); i++) {
+      if (!results[i].replayed) {
+        std::cerr << argv[0] << ": Could not replay '" << recFiles[i] << "'." << std::endl;
+        allReplayed = false;
+        continue;
+      }
+      print(recFiles[i], results[i].evaluation);
+      all.merge(results[i].evaluation);
+    }
+    print("all", all);
+
+    // Timing depends on the machine; only the accuracy decides the exit code.
+    retCode = (allReplayed && all.accepted()) ? 0 : 1;
+  }
+  return retCode;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STEERING_OUTPUT_HPP
+#define STEERING_OUTPUT_HPP
+
+#include "steering-detector.hpp"
+
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+// Writes the steering wheel angle of every frame as a line
+// group_16;<sample time stamp in microseconds>;<steering wheel angle>.
+class ConsoleSink {
+ public:
+  // Lines are flushed unless nobody reads them while they are written.
+  explicit ConsoleSink(std::ostream &out, bool flushEveryLine = true) noexcept
+      : m_out(out)
+      , m_flushEveryLine{flushEveryLine} {}
+
+  void write(uint64_t sMicro, float steeringWheelAngle) {
+    m_out << "group_16;" << sMicro << ";" << steeringWheelAngle << '\n';
+    if (m_flushEveryLine) {
+      m_out.flush();
+    }
+  }
+
+ private:
+  std::ostream &m_out;
+  bool m_flushEveryLine;
+};
+
+// Draws the computed and the actual steering wheel angle onto a frame.
+class OverlaySink {
+ public:
+  static std::string text(float steeringWheelAngle, float groundSteering, uint64_t sMicro) {
+    // creates string stream input, optimized buffer, convert whatever is coming in as string
+    std::ostringstream calcGroundSteering;
+    std::ostringstream actualSteering;
+    std::ostringstream timestamp;
+
+    // putting values into stream
+    calcGroundSteering << steeringWheelAngle;
+    actualSteering << groundSteering;
+    timestamp << sMicro;
+
+    // creating strings for printing
+    std::string time = " Time Stamp: ";
+    std::string calculatedGroundSteering = "Calculated Ground Steering: ";
+    std::string actualGroundSteering = " Actual Ground Steering: ";
+    std::string groundSteeringAngle = std::to_string(steeringWheelAngle);
+
+    // appending into one string to display
+    calculatedGroundSteering.append(groundSteeringAngle);
+    calculatedGroundSteering.append(calcGroundSteering.str());
+    calculatedGroundSteering.append(actualGroundSteering);
+    calculatedGroundSteering.append(actualSteering.str());
+    calculatedGroundSteering.append(time);
+    calculatedGroundSteering.append(timestamp.str());
+    return calculatedGroundSteering;
+  }
+
+  void draw(cv::Mat &img, float steeringWheelAngle, float groundSteering, uint64_t sMicro) {
+    // Displays information on video
+    cv::putText(img, //target image
+                text(steeringWheelAngle, groundSteering, sMicro), cv::Point(1, 50), cv::FONT_HERSHEY_DUPLEX, 0.35, CV_RGB(0, 250, 154));
+  }
+};
+
+// Pop up windows used for testing.
+class DebugWindows {
+ public:
+  // Windows showing only the blue and yellow contours
+  void show(const SteeringDetectorContours &contours) {
+    if (!contours.blue.empty()) {
+      cv::imshow("Blue Contours", contours.blue);
+      cv::waitKey(1);
+    }
+    if (!contours.yellow.empty()) {
+      cv::imshow("Yellow Contours", contours.yellow);
+      cv::waitKey(1);
+    }
+  }
+
+  // Window showing the frame with the overlay
+  void show(const cv::Mat &img) {
+    cv::imshow("Debug", img);
+    cv::waitKey(1);
+  }
+};
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef STEERING_POLICY_HPP
+#define STEERING_POLICY_HPP
+
+#include "blob-extractor.hpp"
+#include "steering-config.hpp"
+
+// Finds out in which direction the car drives around the track from the
+// first frames of a run.
+class DirectionEstimator {
+ public:
+  explicit DirectionEstimator(const SteeringDetectorConfig &config = SteeringDetectorConfig{}) noexcept
+      : m_frameSampleSize{config.frameSampleSize}
+      , m_identifiedShape{config.identifiedShape} {}
+
+  // Advance by one frame; true if the direction is still sampled in this frame.
+  bool next() noexcept {
+    // Increase the frameCounter variable to get our sample frames for carDirection
+    m_frameCounter++;
+
+    // Loop runs until frame counter is greater than the sample size, used to determine direction (counterclockwise, clockwise etc...)
+    return m_frameCounter < m_frameSampleSize;
+  }
+
+  // Sample the blobs of YELLOW_RIGHT of a frame for which next() was true.
+  void sample(const BlobAreas &yellowRight) noexcept {
+    // Any yellow cone on the right means that the car direction is clockwise
+    for (double area : yellowRight) {
+      if (area > m_identifiedShape) {
+        m_carDirection = 1;
+      }
+    }
+  }
+
+  int carDirection() const noexcept {
+    return m_carDirection;
+  }
+
+  int frameCounter() const noexcept {
+    return m_frameCounter;
+  }
+
+ private:
+  int m_frameSampleSize;
+  int m_identifiedShape;
+
+  int m_frameCounter{0};
+  int m_carDirection{-1}; // left car direction is negative (counterclockwise), default value
+};
+
+// Steers away from the cones in the centre of the frames once the direction
+// of the car is known.
+class SteeringPolicy {
+ public:
+  explicit SteeringPolicy(const SteeringDetectorConfig &config = SteeringDetectorConfig{}) noexcept
+      : m_config{config} {}
+
+  // Steering wheel angle of the next frame; areasOf(channel) must return the
+  // BlobAreas of BLUE_CENTRE and YELLOW_CENTRE and is only called as needed.
+  template <typename AreasOf>
+  float update(int carDirection, AreasOf &&areasOf) {
+    // Turn right when a blue cone is detected in clockwise direction and left otherwise, to steer away from the cone
+    const bool blueConeCenter{followCones(areasOf(BLUE_CENTRE), carDirection, m_config.carTurnR, m_config.carTurnL)};
+
+    // If a blue cone hasn't been detected, we check for yellow cones and steer the other way
+    if (!blueConeCenter) {
+      const bool yellowConeCenter{followCones(areasOf(YELLOW_CENTRE), carDirection, m_config.carTurnL, m_config.carTurnR)};
+
+      // If no cones are present, the steeringWheelAngle is set to 0
+      if (!yellowConeCenter) {
+        m_steeringWheelAngle = 0.0f;
+      }
+    }
+    return m_steeringWheelAngle;
+  }
+
+  float steeringWheelAngle() const noexcept {
+    return m_steeringWheelAngle;
+  }
+
+ private:
+  // Adjust the steering wheel angle once if there are cones among the blobs;
+  // return true if at least one cone was found.
+  bool followCones(const BlobAreas &areas, int carDirection, float turnClockwise, float turnCounterclockwise) noexcept {
+    bool coneCenter{false};
+    for (double area : areas) {
+      if (area > m_config.identifiedShape) {
+        if (m_steeringWheelAngle > m_config.steeringMin && m_steeringWheelAngle < m_config.steeringMax) {
+          if (!coneCenter && 1 == carDirection) {
+            m_steeringWheelAngle = m_steeringWheelAngle - turnClockwise;
+          } else if (!coneCenter && -1 == carDirection) {
+            m_steeringWheelAngle = m_steeringWheelAngle - turnCounterclockwise;
+          }
+        } else {
+          // Go straight, no new steering angle provided by driver
+          m_steeringWheelAngle = 0.0f;
+        }
+        coneCenter = true;
+      }
+    }
+    return coneCenter;
+  }
+
+ private:
+  SteeringDetectorConfig m_config;
+
+  float m_steeringWheelAngle{0.0f};
+};
+
+#endif
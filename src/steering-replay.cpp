@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Include the single-file, header-only middleware libcluon to create high-performance microservices
+#include "cluon-complete.hpp"
+
+#include "cluon-complete.cpp"
+
+// Include the OpenDLV Standard Message Set that contains messages that are usually exchanged for automotive or robotic applications
+#include "opendlv-standard-message-set.hpp"
+
+// Include the cone detection shared with the live microservice and the offline replay of recordings
+#include "steering-detector.hpp"
+#include "steering-output.hpp"
+#include "offline-replay.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+int32_t main(int32_t argc, char ** argv) {
+  int32_t retCode {
+    1
+  };
+  auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  if (0 == commandlineArguments.count("rec")) {
+    std::cerr << argv[0] << " computes the steering wheel angles for the frames of a recording as fast as possible." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --rec=<recording> [--frames=<file>] [--csv=<file>]" << std::endl;
+    std::cerr << "         --rec:    .rec file with opendlv.proxy.ImageReading (fourcc BGRA) and opendlv.proxy.GroundSteeringRequest" << std::endl;
+    std::cerr << "         --frames: take the frames from this file written by frame-capture instead of the recording" << std::endl;
+    std::cerr << "         --csv:    also write sampleTimeStamp;steeringWheelAngle;groundSteering per frame to this file" << std::endl;
+    std::cerr << "Example: " << argv[0] << " --rec=recording.rec --csv=result.csv" << std::endl;
+  } else {
+    const std::string REC {
+      commandlineArguments["rec"]
+    };
+    const std::string FRAMES {
+      (0 != commandlineArguments.count("frames")) ? commandlineArguments["frames"] : ""
+    };
+    const std::string CSV {
+      (0 != commandlineArguments.count("csv")) ? commandlineArguments["csv"] : ""
+    };
+
+    std::ofstream csv;
+    if (!CSV.empty()) {
+      csv.open(CSV, std::ios::out | std::ios::trunc);
+    }
+
+    // Same detection as in the live microservice; only the source of the frames differs
+    SteeringDetector detector;
+    // Same line as printed live; not flushed per frame as nobody consumes it while replaying
+    ConsoleSink console {
+      std::cout, false
+    };
+    OfflineReplay replay {
+      REC, FRAMES
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+    const bool replayed = replay.run([ & detector, & console, & csv](const cv::Mat & img, int64_t sMicro, const opendlv::proxy::GroundSteeringRequest & gsr) {
+      const float steeringWheelAngle {
+        detector.process(img)
+      };
+      console.write(static_cast < uint64_t > (sMicro), steeringWheelAngle);
+      if (csv.is_open()) {
+        csv << sMicro << ";" << steeringWheelAngle << ";" << gsr.groundSteering() << '\n';
+      }
+    });
+    const auto duration = std::chrono::duration_cast < std::chrono::milliseconds > (std::chrono::steady_clock::now() - start);
+
+    if (replayed) {
+      const OfflineReplayStatistics & statistics {
+        replay.statistics()
+      };
+      std::clog << argv[0] << ": Replayed " << statistics.frames << " frames and " << statistics.groundSteeringRequests << " GroundSteeringRequests in " << duration.count() << " ms";
+      if (0 < statistics.skippedFrames) {
+        std::clog << ", skipped " << statistics.skippedFrames << " frames that are not raw BGRA";
+      }
+      std::clog << "." << std::endl;
+      retCode = 0;
+    } else {
+      std::cerr << argv[0] << ": Could not replay '" << REC << "'." << std::endl;
+    }
+  }
+  return retCode;
+}
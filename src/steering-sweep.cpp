@@ -0,0 +1,353 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Include the single-file, header-only middleware libcluon to create high-performance microservices
+#include "cluon-complete.hpp"
+
+#include "cluon-complete.cpp"
+
+// Include the OpenDLV Standard Message Set that contains messages that are usually exchanged for automotive or robotic applications
+#include "opendlv-standard-message-set.hpp"
+
+// Include the cone detection, the cached blobs, the offline replay of recordings, the acceptance rules from the README and the search space
+#include "steering-detector.hpp"
+#include "feature-cache.hpp"
+#include "offline-replay.hpp"
+#include "steering-evaluation.hpp"
+#include "parameter-sweep.hpp"
+#include "work-stealing-pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// A frame of a recording, decoded once and shared by all configurations.
+struct SweepFrame {
+  cv::Mat hsv {}; // bounding region of interest only, converted to HSV
+  float groundSteering {
+    0.0f
+  };
+  bool scored {
+    false
+  }; // false before the first GroundSteeringRequest
+};
+
+struct SweepRecording {
+  bool replayed {
+    false
+  };
+  std::vector < SweepFrame > frames {};
+};
+
+static SweepRecording load(const std::string & recFile, const cv::Rect & roi) {
+  SweepRecording recording;
+  OfflineReplay replay {
+    recFile, OfflineReplay::framesFileFor(recFile)
+  };
+  recording.replayed = replay.run([ & recording, & replay, & roi](const cv::Mat & img, int64_t, const opendlv::proxy::GroundSteeringRequest & gsr) {
+    SweepFrame frame;
+    cv::cvtColor(img(roi), frame.hsv, cv::COLOR_BGR2HSV);
+    frame.groundSteering = gsr.groundSteering();
+    frame.scored = (0 < replay.statistics().groundSteeringRequests);
+    recording.frames.push_back(frame);
+  });
+  return recording;
+}
+
+static SteeringEvaluation evaluate(const SteeringDetectorConfig & config, const SweepRecording & recording) {
+  // The ranking only uses the counts; keeping every frame's time would grow with configurations x frames.
+  SteeringEvaluation evaluation {
+    false
+  };
+  SteeringDetector detector {
+    config
+  };
+  for (const SweepFrame & frame: recording.frames) {
+    const auto start = std::chrono::steady_clock::now();
+    const float steeringWheelAngle {
+      detector.processHsv(frame.hsv)
+    };
+    const int64_t processingTime {
+      std::chrono::duration_cast < std::chrono::microseconds > (std::chrono::steady_clock::now() - start).count()
+    };
+    if (frame.scored) {
+      evaluation.add(steeringWheelAngle, frame.groundSteering, processingTime);
+    } else {
+      evaluation.addUnscored(processingTime);
+    }
+  }
+  return evaluation;
+}
+
+// The recording and the frames file that OfflineReplay reads its frames from.
+static FeatureSource sourceOf(const std::string & recFile) {
+  return FeatureSource::of(recFile, OfflineReplay::framesFileFor(recFile));
+}
+
+// Run the cone segmentation of the base configuration over a recording once and store the blobs next to it.
+static bool cacheFeatures(const std::string & recFile, const SteeringDetectorConfig & config) {
+  // Taken before replaying, so that a recording replaced meanwhile does not match next time.
+  const FeatureSource source {
+    sourceOf(recFile)
+  };
+  FeatureExtractor extractor {
+    config
+  };
+  FeatureCacheWriter writer;
+  FrameFeatures features;
+  const cv::Rect roi {
+    config.boundingRegionOfInterest()
+  };
+  OfflineReplay replay {
+    recFile, OfflineReplay::framesFileFor(recFile)
+  };
+  const bool replayed {
+    replay.run([ & extractor, & writer, & features, & replay, & roi](const cv::Mat & img, int64_t sampleTimeStamp, const opendlv::proxy::GroundSteeringRequest & gsr) {
+      extractor.extract(img, false, features);
+      features.sampleTimeStamp = sampleTimeStamp;
+      features.frameHash = frameHash(img(roi));
+      features.groundSteering = gsr.groundSteering();
+      features.scored = (0 < replay.statistics().groundSteeringRequests);
+      writer.add(features);
+    })
+  };
+  return replayed && writer.write(FeatureCache::featuresFileFor(recFile), perceptionKey(config), source);
+}
+
+// Same as evaluate(...) for a configuration that differs from the cached one in its controller parameters only.
+static SteeringEvaluation evaluateFeatures(const SteeringDetectorConfig & config, const FeatureCacheReader & features) {
+  SteeringEvaluation evaluation {
+    false
+  };
+  SteeringController controller {
+    config
+  };
+  for (std::size_t i = 0; i < features.size(); i++) {
+    const float steeringWheelAngle {
+      controller.update([ & features, i](ConeChannel channel) {
+        return features.areas(i, channel);
+      })
+    };
+    // Without the cone segmentation, the time per frame says nothing about the live microservice.
+    if (features.scored(i)) {
+      evaluation.add(steeringWheelAngle, features.groundSteering(i), 0);
+    } else {
+      evaluation.addUnscored(0);
+    }
+  }
+  return evaluation;
+}
+
+int32_t main(int32_t argc, char ** argv) {
+  int32_t retCode {
+    1
+  };
+  auto commandlineArguments = cluon::getCommandlineArguments(argc, argv);
+  if ((0 == commandlineArguments.count("rec")) ||
+    (0 == commandlineArguments.count("spec"))) {
+    std::cerr << argv[0] << " ranks configurations of the cone detection by the share of correct steering wheel angles." << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --rec=<recording>[,<recording>...] --spec=<file> [--samples=<n>] [--seed=<n>] [--threads=<n>] [--out=<file>] [--top=<n>]" << std::endl;
+    std::cerr << "         --rec:     comma-separated recordings as for steering-evaluator" << std::endl;
+    std::cerr << "         --spec:    parameters to sweep, one per line: <name> = <first>:<last>:<step> or <name> = <value>,<value>,..." << std::endl;
+    std::cerr << "                    names: {blue,yellow}.{min,max}{Hue,Sat,Value}, frameSampleSize, identifiedShape," << std::endl;
+    std::cerr << "                           steeringMin, steeringMax, carTurnR, carTurnL" << std::endl;
+    std::cerr << "         --samples: evaluate this many random configurations instead of the full grid" << std::endl;
+    std::cerr << "         --seed:    seed for the random configurations; default: 1" << std::endl;
+    std::cerr << "         --threads: number of configurations evaluated at the same time; default: number of cores" << std::endl;
+    std::cerr << "         --out:     write the complete ranking to this file" << std::endl;
+    std::cerr << "         --top:     number of configurations to print; default: 10" << std::endl;
+    std::cerr << "Sweeps of frameSampleSize, identifiedShape, steeringMin, steeringMax, carTurnR and carTurnL only replay the" << std::endl;
+    std::cerr << "blobs cached in <recording>.features, which are created on first use." << std::endl;
+    std::cerr << "Example: " << argv[0] << " --rec=track1.rec,track2.rec --spec=sweep.txt --samples=500 --out=ranking.csv" << std::endl;
+  } else {
+    // The full grid grows quickly; beyond this, random samples must be asked for explicitly.
+    constexpr uint64_t MAX_GRID_SIZE {
+      1000000
+    };
+
+    ParameterSweep sweep;
+    {
+      std::ifstream spec(commandlineArguments["spec"]);
+      std::string error;
+      if (!spec.good()) {
+        std::cerr << argv[0] << ": Could not open '" << commandlineArguments["spec"] << "'." << std::endl;
+        return retCode;
+      }
+      if (!sweep.parse(spec, error)) {
+        std::cerr << argv[0] << ": " << commandlineArguments["spec"] << ": " << error << std::endl;
+        return retCode;
+      }
+    }
+    if ((0 == commandlineArguments.count("samples")) && (MAX_GRID_SIZE < sweep.gridSize())) {
+      std::cerr << argv[0] << ": The grid has more than " << MAX_GRID_SIZE << " configurations; use --samples." << std::endl;
+      return retCode;
+    }
+    const std::vector < ParameterSweep::Values > configurations {
+      (0 != commandlineArguments.count("samples")) ?
+      sweep.random(std::stoull(commandlineArguments["samples"]), (0 != commandlineArguments.count("seed")) ? static_cast < uint32_t > (std::stoul(commandlineArguments["seed"])) : 1) :
+      sweep.grid()
+    };
+
+    std::vector < std::string > recFiles;
+    {
+      std::stringstream sstr {
+        commandlineArguments["rec"]
+      };
+      std::string recFile;
+      while (std::getline(sstr, recFile, ',')) {
+        if (!recFile.empty()) {
+          recFiles.push_back(recFile);
+        }
+      }
+    }
+
+    const uint32_t THREADS {
+      (0 != commandlineArguments.count("threads")) ? static_cast < uint32_t > (std::stoi(commandlineArguments["threads"])) : std::max(1u, std::thread::hardware_concurrency())
+    };
+    const std::size_t TOP {
+      (0 != commandlineArguments.count("top")) ? static_cast < std::size_t > (std::stoul(commandlineArguments["top"])) : 10
+    };
+    // The pool keeps all cores busy already; OpenCV's own threads would only compete for them.
+    cv::setNumThreads(1);
+    WorkStealingPool pool {
+      THREADS
+    };
+
+    // Decode every recording once; the swept parameters do not change the regions of interest.
+    const SteeringDetectorConfig BASE;
+    const cv::Rect ROI {
+      BASE.boundingRegionOfInterest()
+    };
+    const bool CONTROLLER_ONLY {
+      sweep.controllerOnly()
+    };
+    std::vector < SweepRecording > recordings(recFiles.size());
+    std::vector < std::unique_ptr < FeatureCacheReader > > features(recFiles.size());
+    {
+      std::vector < WorkStealingPool::Task > tasks;
+      for (std::size_t r = 0; r < recFiles.size(); r++) {
+        tasks.push_back([ & recordings, & features, & recFiles, & BASE, & ROI, CONTROLLER_ONLY, r]() {
+          if (!CONTROLLER_ONLY) {
+            recordings[r] = load(recFiles[r], ROI);
+            return;
+          }
+          // Blobs cached with other HSV ranges or regions of interest, or from a recording that was replaced since, are replaced.
+          const std::string featuresFile {
+            FeatureCache::featuresFileFor(recFiles[r])
+          };
+          features[r].reset(new FeatureCacheReader(featuresFile));
+          if (!features[r] -> valid() || (perceptionKey(BASE) != features[r] -> perceptionKey()) || (sourceOf(recFiles[r]) != features[r] -> source())) {
+            features[r].reset();
+            if (cacheFeatures(recFiles[r], BASE)) {
+              features[r].reset(new FeatureCacheReader(featuresFile));
+            }
+          }
+          recordings[r].replayed = features[r] && features[r] -> valid();
+        });
+      }
+      pool.run(std::move(tasks));
+    }
+    uint64_t numberOfFrames {
+      0
+    };
+    for (std::size_t r = 0; r < recFiles.size(); r++) {
+      if (!recordings[r].replayed) {
+        std::cerr << argv[0] << ": Could not replay '" << recFiles[r] << "'." << std::endl;
+        return retCode;
+      }
+      numberOfFrames += CONTROLLER_ONLY ? features[r] -> size() : recordings[r].frames.size();
+    }
+    std::clog << argv[0] << ": Evaluating " << configurations.size() << " configurations on " << numberOfFrames << " frames" << (CONTROLLER_ONLY ? " from cached blobs" : "") << " with " << pool.numberOfWorkers() << " threads." << std::endl;
+
+    // One task per configuration and recording; each merges its evaluation into the configuration's result when it finishes.
+    const auto start = std::chrono::steady_clock::now();
+    std::vector < SteeringEvaluation > results(configurations.size(), SteeringEvaluation {
+      false
+    });
+    {
+      const cv::Point ORIGIN(ROI.x, ROI.y);
+      // Tasks of the same configuration on different recordings may finish at the same time; one lock per configuration would be too many.
+      std::array < std::mutex, 64 > resultLocks;
+      std::vector < WorkStealingPool::Task > tasks;
+      for (std::size_t c = 0; c < configurations.size(); c++) {
+        for (std::size_t r = 0; r < recordings.size(); r++) {
+          tasks.push_back([ & results, & resultLocks, & configurations, & recordings, & features, & sweep, & BASE, & ORIGIN, CONTROLLER_ONLY, c, r]() {
+            const SteeringEvaluation evaluation {
+              CONTROLLER_ONLY ?
+                evaluateFeatures(sweep.configFor(configurations[c], BASE), * features[r]) :
+                evaluate(sweep.configFor(configurations[c], BASE).croppedTo(ORIGIN), recordings[r])
+            };
+            std::lock_guard < std::mutex > lock(resultLocks[c % resultLocks.size()]);
+            results[c].merge(evaluation);
+          });
+        }
+      }
+      pool.run(std::move(tasks));
+    }
+    const auto duration = std::chrono::duration_cast < std::chrono::milliseconds > (std::chrono::steady_clock::now() - start);
+    std::clog << argv[0] << ": Evaluated in " << duration.count() << " ms." << std::endl;
+
+    // Best share of correct frames first; ties are broken by the frames at 0 and then by the order of evaluation.
+    std::vector < std::size_t > ranking(configurations.size());
+    std::iota(ranking.begin(), ranking.end(), 0);
+    std::stable_sort(ranking.begin(), ranking.end(), [ & results](std::size_t a, std::size_t b) {
+      if (results[a].correctFrames() != results[b].correctFrames()) {
+        return results[a].correctFrames() > results[b].correctFrames();
+      }
+      return results[a].correctFramesAtZero() > results[b].correctFramesAtZero();
+    });
+
+    auto printRanking = [ & ranking, & results, & configurations, & sweep](std::ostream & out, std::size_t rows) {
+      out << "rank;correct_percent;correct;frames;correct_at_zero;frames_at_zero;result";
+      for (const auto & parameter: sweep.parameters()) {
+        out << ";" << parameter.name;
+      }
+      out << std::endl;
+      for (std::size_t i = 0; i < std::min(rows, ranking.size()); i++) {
+        const SteeringEvaluation & result {
+          results[ranking[i]]
+        };
+        out << (i + 1) << ";"
+          << std::fixed << std::setprecision(2) << 100.0 * result.ratio() << ";"
+          << result.correctFrames() << ";" << result.frames() << ";"
+          << result.correctFramesAtZero() << ";" << result.framesAtZero() << ";"
+          << (result.accepted() ? "pass" : "fail");
+        out << std::defaultfloat << std::setprecision(6);
+        for (double value: configurations[ranking[i]]) {
+          out << ";" << value;
+        }
+        out << std::endl;
+      }
+    };
+    printRanking(std::cout, TOP);
+    if (0 != commandlineArguments.count("out")) {
+      std::ofstream out(commandlineArguments["out"], std::ios::out | std::ios::trunc);
+      printRanking(out, ranking.size());
+    }
+    retCode = 0;
+  }
+  return retCode;
+}
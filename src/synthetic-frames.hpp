@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SYNTHETIC_FRAMES_HPP
+#define SYNTHETIC_FRAMES_HPP
+
+#include "steering-detector.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <algorithm>
+#include <cstdint>
+
+// Frames with blue and yellow cones on a noisy grey track for measuring the
+// cone detection without recordings. The pixels only depend on the size and
+// the index of a frame, so every machine measures the same work.
+//
+// The regions of interest of the default configuration are for 640x480; for
+// other sizes, use SyntheticFrames::config(size).
+class SyntheticFrames {
+ public:
+  // BGR colours inside the default HSV ranges: hue 120, saturation 129, value
+  // 150 for blue and hue 25, saturation 150, value 220 for yellow.
+  static cv::Scalar blue() noexcept {
+    return cv::Scalar(150, 74, 74, 255);
+  }
+  static cv::Scalar yellow() noexcept {
+    return cv::Scalar(91, 198, 220, 255);
+  }
+
+  // Default configuration with the regions of interest scaled to size.
+  static SteeringDetectorConfig config(const cv::Size &size) noexcept {
+    SteeringDetectorConfig config;
+    for (cv::Rect *roi : {&config.regionOfInterestRight, &config.regionOfInterestCentre}) {
+      *roi = cv::Rect(roi->x * size.width / 640, roi->y * size.height / 480, roi->width * size.width / 640, roi->height * size.height / 480);
+    }
+    return config;
+  }
+
+  // BGRA frame number index; the cones move a little from frame to frame.
+  static cv::Mat frame(const cv::Size &size, uint32_t index) {
+    cv::Mat img(size, CV_8UC4);
+
+    // Grey with deterministic noise of +/- 20, which stays outside of both HSV ranges
+    uint32_t state{2166136261u ^ index};
+    for (int row{0}; row < img.rows; row++) {
+      uint8_t *pixel{img.ptr<uint8_t>(row)};
+      for (int col{0}; col < img.cols; col++, pixel += 4) {
+        state = state * 1664525u + 1013904223u;
+        pixel[0] = static_cast<uint8_t>(80 + ((state >> 8) % 41));
+        pixel[1] = static_cast<uint8_t>(80 + ((state >> 16) % 41));
+        pixel[2] = static_cast<uint8_t>(80 + ((state >> 24) % 41));
+        pixel[3] = 255;
+      }
+    }
+
+    // Blue cones on the left and yellow cones on the right of the track, as seen driving counterclockwise
+    const SteeringDetectorConfig cfg{config(size)};
+    const int shift{static_cast<int>(index % 16) * size.width / 640};
+    const cv::Rect &centre{cfg.regionOfInterestCentre};
+    const cv::Rect &right{cfg.regionOfInterestRight};
+    cone(img, cv::Point(centre.x + centre.width / 4 + shift, centre.y + centre.height / 2), size, blue());
+    cone(img, cv::Point(centre.x + 3 * centre.width / 4 - shift, centre.y + centre.height / 2), size, yellow());
+    cone(img, cv::Point(right.x + right.width / 2 - shift, right.y + right.height / 2), size, yellow());
+    return img;
+  }
+
+ private:
+  // Triangle of about 5% of the frame width standing on base.
+  static void cone(cv::Mat &img, const cv::Point &base, const cv::Size &size, const cv::Scalar &colour) {
+    const int halfWidth{std::max(2, size.width / 40)};
+    const int height{std::max(4, size.width / 16)};
+    const cv::Point corners[3]{cv::Point(base.x - halfWidth, base.y + height / 2), cv::Point(base.x + halfWidth, base.y + height / 2),
+                               cv::Point(base.x, base.y - height / 2)};
+    cv::fillConvexPoly(img, corners, 3, colour);
+  }
+};
+
+#endif
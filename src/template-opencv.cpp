@@ -23,12 +23,28 @@
 // Include the OpenDLV Standard Message Set that contains messages that are usually exchanged for automotive or robotic applications 
 #include "opendlv-standard-message-set.hpp"
 
-// Include the GUI and image processing header files from OpenCV
-#include <opencv2/highgui/highgui.hpp>
+// Include the frames from shared memory and the outputs of the steering wheel angle
+#include "frame-source.hpp"
+#include "steering-output.hpp"
 
-#include <opencv2/imgproc/imgproc.hpp>
- // Include the string stream library to use instead of buffer
-#include <sstream>
+// Include the lock-free cell used to share the latest received messages with the frame loop
+#include "latest-value.hpp"
+
+// Include the cone detection that computes the steering wheel angle
+#include "steering-detector.hpp"
+
+// Include the time measurement per stage of the frame loop and the timeline of all threads; only active when built with STAGE_PROFILING
+#include "stage-profiler.hpp"
+#include "chrome-trace.hpp"
+
+// Include the age of the frames when their steering wheel angle is emitted
+#include "end-to-end-latency.hpp"
+
+// Include the quality levels of the cone detection for when frames take too long
+#include "deadline-controller.hpp"
+
+// Include the scheduling, core and memory settings for the frame loop
+#include "realtime.hpp"
 
 int32_t main(int32_t argc, char ** argv) {
   int32_t retCode {
@@ -41,11 +57,23 @@ int32_t main(int32_t argc, char ** argv) {
     (0 == commandlineArguments.count("width")) ||
     (0 == commandlineArguments.count("height"))) {
     std::cerr << argv[0] << " attaches to a shared memory area containing an ARGB image." << std::endl;
-    std::cerr << "Usage:   " << argv[0] << " --cid=<OD4 session> --name=<name of shared memory area> [--verbose]" << std::endl;
+    std::cerr << "Usage:   " << argv[0] << " --cid=<OD4 session> --name=<name of shared memory area> [--verbose] [--profile=<seconds> [--counters]] [--trace=<file>] [--latency=<seconds>] [--deadline=<ms>]" << std::endl;
+    std::cerr << "         [--cpu=<cores>] [--helper-cpus=<cores>] [--sched=fifo:<priority>|deadline:<runtime ms>/<period ms>] [--mlock] [--prefault]" << std::endl;
     std::cerr << "         --cid:    CID of the OD4Session to send and receive messages" << std::endl;
     std::cerr << "         --name:   name of the shared memory area to attach" << std::endl;
     std::cerr << "         --width:  width of the frame" << std::endl;
     std::cerr << "         --height: height of the frame" << std::endl;
+    std::cerr << "         --profile: print the time per stage of the frame loop every <seconds> (requires -DSTAGE_PROFILING=ON)" << std::endl;
+    std::cerr << "         --counters: add cycles, instructions, cache and branch misses per stage to --profile (requires -DSTAGE_PROFILING=ON)" << std::endl;
+    std::cerr << "         --trace:   write a timeline of the stages of all threads to <file> on exit and on SIGUSR1 (requires -DSTAGE_PROFILING=ON)" << std::endl;
+    std::cerr << "         --latency: print the age of the frames from their time stamp to the output of their steering wheel angle every <seconds>" << std::endl;
+    std::cerr << "         --deadline: lower the quality of the cone detection when frames take longer than this to process, and raise it again when there is headroom" << std::endl;
+    std::cerr << "         --cpu:     run the frame loop only on these cores, e.g. 3 or 2,3" << std::endl;
+    std::cerr << "         --helper-cpus: run the network threads of libcluon only on these cores, e.g. 0-1" << std::endl;
+    std::cerr << "         --sched:   run the frame loop with SCHED_FIFO at <priority> (1..99) or SCHED_DEADLINE with <runtime> per <period>" << std::endl;
+    std::cerr << "         --mlock:   keep all memory of the process in RAM" << std::endl;
+    std::cerr << "         --prefault: allocate and touch the buffers of the frame loop before the first frame" << std::endl;
+    std::cerr << "         Settings that lack privileges are reported and skipped." << std::endl;
     std::cerr << "Example: " << argv[0] << " --cid=253 --name=img --width=640 --height=480 --verbose" << std::endl;
   } else {
     // Extract the values from the command line parameters
@@ -61,358 +89,279 @@ int32_t main(int32_t argc, char ** argv) {
     const bool VERBOSE {
       commandlineArguments.count("verbose") != 0
     };
+    const uint32_t PROFILE {
+      (0 != commandlineArguments.count("profile")) ? static_cast < uint32_t > (std::stoi(commandlineArguments["profile"])) : 0
+    };
+    const std::string TRACE {
+      (0 != commandlineArguments.count("trace")) ? commandlineArguments["trace"] : ""
+    };
+    const uint32_t LATENCY {
+      (0 != commandlineArguments.count("latency")) ? static_cast < uint32_t > (std::stoi(commandlineArguments["latency"])) : 0
+    };
+    const uint32_t DEADLINE {
+      (0 != commandlineArguments.count("deadline")) ? static_cast < uint32_t > (std::stoi(commandlineArguments["deadline"])) : 0
+    };
+    std::vector < int > frameCpus;
+    std::vector < int > helperCpus;
+    if (((0 != commandlineArguments.count("cpu")) && !Realtime::parseCpus(commandlineArguments["cpu"], frameCpus)) ||
+      ((0 != commandlineArguments.count("helper-cpus")) && !Realtime::parseCpus(commandlineArguments["helper-cpus"], helperCpus))) {
+      std::cerr << argv[0] << ": Expected a list of cores such as 3, 0,2 or 0-3." << std::endl;
+      return retCode;
+    }
+    const std::string SCHED {
+      (0 != commandlineArguments.count("sched")) ? commandlineArguments["sched"] : ""
+    };
+    int fifoPriority {
+      0
+    };
+    int deadlineRuntime {
+      0
+    };
+    int deadlinePeriod {
+      0
+    };
+    if (!SCHED.empty() && (1 != std::sscanf(SCHED.c_str(), "fifo:%d", & fifoPriority)) && (2 != std::sscanf(SCHED.c_str(), "deadline:%d/%d", & deadlineRuntime, & deadlinePeriod))) {
+      std::cerr << argv[0] << ": Expected --sched=fifo:<priority> or --sched=deadline:<runtime ms>/<period ms>." << std::endl;
+      return retCode;
+    }
+    const bool MLOCK {
+      0 != commandlineArguments.count("mlock")
+    };
+    const bool PREFAULT {
+      0 != commandlineArguments.count("prefault")
+    };
 
     // Attach to the shared memory.
-    std::unique_ptr < cluon::SharedMemory > sharedMemory {
-      new cluon::SharedMemory {
-        NAME
-      }
+    SharedMemoryFrameSource frameSource {
+      NAME, WIDTH, HEIGHT
     };
-    if (sharedMemory && sharedMemory -> valid()) {
-      std::clog << argv[0] << ": Attached to shared memory '" << sharedMemory -> name() << " (" << sharedMemory -> size() << " bytes)." << std::endl;
+    if (frameSource.valid()) {
+      std::clog << argv[0] << ": Attached to shared memory '" << frameSource.sharedMemory().name() << " (" << frameSource.sharedMemory().size() << " bytes)." << std::endl;
+
+      // The latest GroundSteeringRequest is written by the OD4 receiver thread and read by the frame loop without locking
+      LatestValue < opendlv::proxy::GroundSteeringRequest > latestGsr;
+      // Reused by the OD4 receiver thread to index incoming requests and to decode only the fields that are read
+      cluon::LazyProtoDecoder < opendlv::proxy::GroundSteeringRequest > gsrDecoder;
+      // Field groundSteering [id = 1] of opendlv.proxy.GroundSteeringRequest
+      constexpr uint32_t GROUND_STEERING_FIELD_ID {
+        1
+      };
+
+      // Lock before libcluon starts its threads so that their stacks are locked as well.
+      std::string error;
+      if (MLOCK && !Realtime::lockMemory(error)) {
+        std::clog << argv[0] << ": Could not lock the memory (" << error << "); continuing without." << std::endl;
+      }
+      // Threads inherit the cores of the thread that starts them, so the frame loop takes the cores of
+      // the helper threads until the OD4Session has started them.
+      const std::vector < int > allCpus {
+        Realtime::cpusOfThisThread()
+      };
+      if (!helperCpus.empty() && !Realtime::pinThisThread(helperCpus, error)) {
+        std::clog << argv[0] << ": Could not pin the helper threads (" << error << "); continuing without." << std::endl;
+      }
 
       // Interface to a running OpenDaVINCI session where network messages are exchanged.
       // The instance od4 allows you to send and receive messages.
+      // It is declared after the data used by its callbacks so that it is stopped first.
       cluon::OD4Session od4 {
         static_cast < uint16_t > (std::stoi(commandlineArguments["cid"]))
       };
 
-      opendlv::proxy::GroundSteeringRequest gsr;
-      std::mutex gsrMutex;
-      auto onGroundSteeringRequest = [ & gsr, & gsrMutex](cluon::data::Envelope && env) {
+      auto onGroundSteeringRequest = [ & latestGsr, & gsrDecoder](cluon::data::Envelope && env) {
+        Tracer::instance().nameThisThread("OD4 pipeline");
+        TraceSpan span {
+          "GroundSteeringRequest"
+        };
         // The envelope data structure provide further details, such as sampleTimePoint as shown in this test case:
         // https://github.com/chrberger/libcluon/blob/master/libcluon/testsuites/TestEnvelopeConverter.cpp#L31-L40
-        std::lock_guard < std::mutex > lck(gsrMutex);
-        gsr = cluon::extractMessage < opendlv::proxy::GroundSteeringRequest > (std::move(env));
+        if (cluon::extractMessage(std::move(env), gsrDecoder)) {
+          latestGsr.store(gsrDecoder.field(GROUND_STEERING_FIELD_ID));
+        }
         //std::cout << "lambda: groundSteering = " << gsr.groundSteering() << std::endl;
       };
 
       od4.dataTrigger(opendlv::proxy::GroundSteeringRequest::ID(), onGroundSteeringRequest);
 
-      // HSV values for blue
-      int minHueBlue = 102;
-      int maxHueBlue = 150;
-      int minSatBlue = 88;
-      int maxSatBlue = 165;
-      int minValueBlue = 43;
-      int maxValueBlue = 222;
-
-      //HSV values for yellow
-      int minHueYellow = 0;
-      int maxHueYellow = 42;
-      int minSatYellow = 75;
-      int maxSatYellow = 221;
-      int minValueYellow = 170;
-      int maxValueYellow = 255;
+      // The frame loop gets its own cores and scheduling only now so that the helper threads do not inherit them.
+      // SCHED_DEADLINE is only admitted for threads that may run on all cores.
+      if ((0 < deadlineRuntime) && !frameCpus.empty()) {
+        std::clog << argv[0] << ": Ignoring --cpu as SCHED_DEADLINE needs all cores." << std::endl;
+        frameCpus.clear();
+      }
+      if ((!frameCpus.empty() || !helperCpus.empty()) && !Realtime::pinThisThread(frameCpus.empty() ? allCpus : frameCpus, error)) {
+        std::clog << argv[0] << ": Could not pin the frame loop (" << error << "); continuing without." << std::endl;
+      }
+      if ((0 < fifoPriority) && !Realtime::setFifo(fifoPriority, error)) {
+        std::clog << argv[0] << ": Could not use SCHED_FIFO (" << error << "); continuing with the default scheduling." << std::endl;
+      }
+      if ((0 < deadlineRuntime) && !Realtime::setDeadline(std::chrono::milliseconds(deadlineRuntime), std::chrono::milliseconds(deadlinePeriod), error)) {
+        std::clog << argv[0] << ": Could not use SCHED_DEADLINE (" << error << "); continuing with the default scheduling." << std::endl;
+      }
 
-      int frameCounter = 0; // used to count starting frames
-      int frameSampleSize = 5; // initial number of frames used to determine direction
+      // Follows the cones in the frames; shared with the offline replay so that both compute the same steering wheel angles
+      SteeringDetector detector;
+      SteeringDetectorContours contours;
 
-      int identifiedShape = 60; // pixel size used to determine cones
-      int yellowConeExists = 0; // flag to check if blue cones have been detected
+      // Outputs of every frame
+      ConsoleSink console {
+        std::cout
+      };
+      OverlaySink overlay;
+      DebugWindows debugWindows;
 
-      // Variables for steering angle calculation
-      float steeringWheelAngle = 0.0;
-      float steeringMax = 0.3;
-      float steeringMin = -0.3;
-      int carDirection = -1; // left car direction is negative (counterclockwise), default value
+      // Time per stage; without --profile and --trace, no time is measured at all
+      StageProfiler stageProfiler {
+        std::chrono::seconds(PROFILE)
+      };
+      StageProfiler * profiler {
+        (StageProfiler::ENABLED && ((0 < PROFILE) || !TRACE.empty())) ? & stageProfiler : nullptr
+      };
+      if (((0 < PROFILE) || !TRACE.empty()) && !StageProfiler::ENABLED) {
+        std::clog << argv[0] << ": Ignoring --profile and --trace; build with -DSTAGE_PROFILING=ON to measure the stages." << std::endl;
+      }
+      detector.setProfiler(profiler);
+      if ((nullptr != profiler) && (0 < PROFILE) && (0 != commandlineArguments.count("counters"))) {
+        if (!profiler -> enableCounters(error)) {
+          std::clog << argv[0] << ": Hardware counters are not available (" << error << "); measuring time only." << std::endl;
+        }
+      }
+      if ((nullptr != profiler) && !TRACE.empty()) {
+        Tracer::instance().start(TRACE);
+        Tracer::instance().nameThisThread("frame loop");
+        Tracer::installSignalHandlers();
+      }
 
-      // Variables for turning
-      float carTurnR = 0.025;
-      float carTurnL = -0.025;
+      // Age of the frames until their steering wheel angle is emitted; only measured with --latency
+      EndToEndLatency endToEndLatency {
+        std::chrono::seconds(LATENCY)
+      };
+      EndToEndLatency * latency {
+        (0 < LATENCY) ? & endToEndLatency : nullptr
+      };
 
-      cv::Mat rightContourImage; // stores image when identifying car direction
+      // Quality of the cone detection under load; only adapted with --deadline
+      DeadlineController deadlineController {
+        std::chrono::milliseconds(DEADLINE)
+      };
+      DeadlineController * deadline {
+        (0 < DEADLINE) ? & deadlineController : nullptr
+      };
+      float steeringWheelAngle {
+        0.0f
+      };
 
-      // Vectors used for storing cone contours 
-      std::vector < std::vector < cv::Point > > contours;
-      std::vector < cv::Vec4i > hierarchy;
+      // Frame buffer reused by every frame, so it is allocated once.
+      cv::Mat img;
+      if (PREFAULT) {
+        img.create(static_cast < int > (HEIGHT), static_cast < int > (WIDTH), CV_8UC4);
+        img.setTo(cv::Scalar(0, 0, 0, 0));
+        detector.prefault(cv::Size(static_cast < int > (WIDTH), static_cast < int > (HEIGHT)));
+        Realtime::prefaultStack(512 * 1024);
+      }
 
       // Endless loop; end the program by pressing Ctrl-C.
-      while (od4.isRunning()) {
-
-        // Increase the frameCounter variable to get our sample frames for carDirection
-        frameCounter++;
-
-        // OpenCV data structure to hold an image.
-        cv::Mat img;
+      while (od4.isRunning() && !Tracer::stopRequested()) {
+        TraceSpan frameSpan {
+          "frame"
+        };
 
         // Wait for a notification of a new frame.
-        sharedMemory -> wait();
-
-        // Lock the shared memory.
-        sharedMemory -> lock(); {
-          // Copy the pixels from the shared memory into our own data structure.
-          cv::Mat wrapped(HEIGHT, WIDTH, CV_8UC4, sharedMemory -> data());
-          img = wrapped.clone();
+        {
+          StageTimer timer {
+            profiler, PipelineStage::WAIT
+          };
+          frameSource.wait();
         }
 
-        std::pair < bool, cluon::data::TimeStamp > sTime = sharedMemory -> getTimeStamp(); // Saving current time in sTime var
-
-        // Convert TimeStamp obj into microseconds
-        uint64_t sMicro = cluon::time::toMicroseconds(sTime.second);
-
-        //Shared memory is unlocked
-        sharedMemory -> unlock();
-
-        // Defining images for later use
-        cv::Mat hsvRightImg;
-        cv::Mat hsvCenterImg;
-        cv::Mat detectRightImg;
-        cv::Mat detectCenterImg;
-
-        // loop runs until frame counter is greater than the sample size of 5, used to determine direction (counterclockwise, clockwise etc...)
-        if (frameCounter < frameSampleSize) {
-          // Operation to find yellow cones in HSV image
-
-          // Defining the regions of interest for the right
-          cv::Rect regionOfInterestRight = cv::Rect(415, 265, 150, 125);
-
-          // Creating image with the defined regions of interest
-          cv::Mat imageWithRegionRight = img(regionOfInterestRight);
-
-          // Converts the imageWithRegionRight image to HSV values and stores the result in hsvRightImg
-          cv::cvtColor(imageWithRegionRight, hsvRightImg, cv::COLOR_BGR2HSV);
-
-          // Applying our defined HSV values as thresholds to hsvRightImg to create a new detectRightImg
-          cv::inRange(hsvRightImg, cv::Scalar(minHueYellow, minSatYellow, minValueYellow), cv::Scalar(maxHueYellow, maxSatYellow, maxValueYellow), detectRightImg);
-
-          //Applying Gaussian blur to detectRightImg
-          cv::GaussianBlur(detectRightImg, detectRightImg, cv::Size(5, 5), 0);
-
-          //Applying dilate and erode to detectLeftImg to remove holes from foreground
-          cv::dilate(detectRightImg, detectRightImg, 0);
-          cv::erode(detectRightImg, detectRightImg, 0);
-
-          // The below will find the contours of the cones in detectRightImg and store them in the contours vector
-          cv::findContours(detectRightImg, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
-
-          // Creates a mat object of the same size as detectRightImg used for storing the drawn contours
-          rightContourImage = cv::Mat::zeros(detectRightImg.rows, detectRightImg.cols, CV_8UC3);
-
-          // Loops over the contours vector
-          for (unsigned int i = 0; i < contours.size(); i++) {
-
-            // If the current index of the vector has a contour area that is larger than the defined number of pixels in identifiedShape, we have a cone
-            if (cv::contourArea(contours[i]) > identifiedShape) {
-
-              // Draws the contour of the cone on the image
-              cv::Scalar colour(255, 255, 0);
-              cv::drawContours(rightContourImage, contours, i, colour, -1, 8, hierarchy);
-
-              // Set yellowConeExists flag to 1 to indicate that we have found a flag
-              yellowConeExists = 1;
-
-              //If yellow cones are detected, that means the car direction is clockwise and the carDirection must be set as 1
-              if (yellowConeExists == 1) {
-                carDirection = 1;
-              }
-            }
-          }
-          // Frame counter printed for testing purposes
-          // std::cout << "frame counter" << frameCounter;
+        uint64_t sMicro {
+          0
+        };
+        const auto frameStart = std::chrono::steady_clock::now();
+        {
+          StageTimer timer {
+            profiler, PipelineStage::LOCK_AND_CLONE
+          };
+          sMicro = frameSource.grab(img);
+        }
+        if (nullptr != latency) {
+          latency -> acquired(static_cast < int64_t > (sMicro));
         }
 
-        // If frameCounter is larger than or equal to frameSampleSize
-        if (frameCounter >= frameSampleSize) {
-
-          // Defining the regions of interest for both centre 
-          cv::Rect regionOfInterestCentre = cv::Rect(200, 245, 230, 115);
-
-          // Creating images with the defined regions of interest
-          cv::Mat imageWithRegionCentre = img(regionOfInterestCentre);
-
-          // Converts the imageWithRegionCentre image to HSV values and stores the result in hsvCenterImg
-          cv::cvtColor(imageWithRegionCentre, hsvCenterImg, cv::COLOR_BGR2HSV);
-
-          // Applying our defined HSV values as thresholds to hsvCenterImg to create a new detectCenterImg
-          cv::inRange(hsvCenterImg, cv::Scalar(minHueBlue, minSatBlue, minValueBlue), cv::Scalar(maxHueBlue, maxSatBlue, maxValueBlue), detectCenterImg);
-
-          //Applying Gaussian blur to detectCenterImg
-          cv::GaussianBlur(detectCenterImg, detectCenterImg, cv::Size(5, 5), 0);
-
-          //Applying dilate and erode to detectCenterImg to remove holes from foreground
-          cv::dilate(detectCenterImg, detectCenterImg, 0);
-          cv::erode(detectCenterImg, detectCenterImg, 0);
-
-          // The below will find the contours of the cones in detectLeftImg and store them in the contours vector
-          cv::findContours(detectCenterImg, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
+        // Contour images are only drawn when they are shown; a skipped frame repeats the last steering wheel angle
+        const bool processed {
+          (nullptr == deadline) || deadline -> process()
+        };
+        if (processed) {
+          steeringWheelAngle = detector.process(img, VERBOSE ? & contours : nullptr);
+        }
+        if (nullptr != latency) {
+          latency -> decided();
+        }
 
-          // Creates a mat object of the same size as detectCenterImg used for storing the drawn contours
-          cv::Mat blueContourImage = cv::Mat::zeros(detectCenterImg.rows, detectCenterImg.cols, CV_8UC3);
+        // Pop up windows used for testing
+        // If verbose is included in the command line, windows showing only the blue and yellow contours will appear
+        if (VERBOSE) {
+          debugWindows.show(contours);
+        }
 
-          int blueConeCenter = 0; // Flag for whether blue cones are detected in the image
+        // Take one consistent snapshot of the latest GroundSteeringRequest for this frame
+        const opendlv::proxy::GroundSteeringRequest gsr {
+          latestGsr.load()
+        };
 
-          // Loops over the contours vector
-          for (unsigned int i = 0; i < contours.size(); i++) {
+        {
+          StageTimer timer {
+            profiler, PipelineStage::PUT_TEXT
+          };
 
-            // If the current index of the vector has a contour area that is larger than the defined number of pixels in identifiedShape, we have a cone
-            if (cv::contourArea(contours[i]) > identifiedShape) {
-              // Draws the contour of the cone on the image
-              cv::Scalar colour(255, 255, 0);
-              cv::drawContours(blueContourImage, contours, i, colour, -1, 8, hierarchy);
-
-              // If the current steeringWheelAngle is more than to steeringMin AND less than to steeringMax 
-              if (steeringWheelAngle > steeringMin && steeringWheelAngle < steeringMax) {
-
-                // If a blue cone has not been detected yet AND car direction is clockwise
-                if (blueConeCenter != 1 && carDirection == 1) {
-                  // Set blueConeCenter as 1 because it has detected a cone 
-                  blueConeCenter = 1;
-
-                  // Turn right when a blue cone is detected, to steer away from the cone
-                  steeringWheelAngle = steeringWheelAngle - carTurnR;
-                  //std::cout << "line 288 " << steeringWheelAngle << std::endl;
-
-                } // If a blue cone has not been detected yet AND car direction is counterclockwise
-                else if (blueConeCenter != 1 && carDirection == -1) {
-                  // Set blueConeCenter as 1 because it has detected a cone 
-                  blueConeCenter = 1;
-
-                  // Turn left when a blue cone is detected, to steer away from the cone
-                  steeringWheelAngle = steeringWheelAngle - carTurnL;
-                  //std::cout << "line 298 " << steeringWheelAngle << std::endl;
-                }
-
-              } // If the current steering angle is less than steeringMin or more than steeringMax 
-              else {
-                // Set steeringWheelAngle to 0 (go straight, no new steering angle provided by driver)
-                blueConeCenter = 1;
-                steeringWheelAngle = 0.0;
-                //std::cout << "line 306 " << steeringWheelAngle << std::endl;
-              }
-
-            }
-          }
-          // Pop up window used for testing 
-          // If verbose is included in the command line, a window showing only the blue contours will appear
-          if (VERBOSE) {
-            cv::imshow("Blue Contours", blueContourImage);
-            cv::waitKey(1);
-          }
-
-          // If a blue cone hasn't been detected, we check for yellow cones
-          if (blueConeCenter != 1) {
-
-            // Converts the imageWithRegionCentre image to HSV values and stores the result in hsvCenterImg
-            cv::cvtColor(imageWithRegionCentre, hsvCenterImg, cv::COLOR_BGR2HSV);
-
-            // Applying our defined HSV values as thresholds to hsvCenterImg to create a new detectCenterImg
-            cv::inRange(hsvCenterImg, cv::Scalar(minHueYellow, minSatYellow, minValueYellow), cv::Scalar(maxHueYellow, maxSatYellow, maxValueYellow), detectCenterImg);
-
-            //Applying Gaussian blur to detectCenterImg
-            cv::GaussianBlur(detectCenterImg, detectCenterImg, cv::Size(5, 5), 0);
-
-            //Applying dilate and erode to detectCenterImg to remove holes from foreground
-            cv::dilate(detectCenterImg, detectCenterImg, 0);
-            cv::erode(detectCenterImg, detectCenterImg, 0);
-
-            // The below will find the contours of the cones in detectLeftImg and store them in the contours vector
-            cv::findContours(detectCenterImg, contours, hierarchy, cv::RETR_TREE, cv::CHAIN_APPROX_SIMPLE);
-
-            // Creates a mat object of the same size as detectCenterImg used for storing the drawn contours
-            cv::Mat yellowContourImage = cv::Mat::zeros(detectCenterImg.rows, detectCenterImg.cols, CV_8UC3);
-
-            int yellowConeCenter = 0; // Flag for whether yellow cones are detected in the image
-
-            // Loops over the contours vector
-            for (unsigned int i = 0; i < contours.size(); i++) {
-              // If the current index of the vector has a contour area that is larger than the defined number of pixels in identifiedShape, we have a cone
-              if (cv::contourArea(contours[i]) > identifiedShape) {
-                // Draws the contour of the cone on the image
-                cv::Scalar colour(255, 255, 0);
-                cv::drawContours(yellowContourImage, contours, i, colour, -1, 8, hierarchy);
-
-                // If the current steeringWheelAngle is more than steeringMin AND less than to steeringMax
-                if (steeringWheelAngle > steeringMin && steeringWheelAngle < steeringMax) {
-
-                  // If a yellow cone has not been detected yet AND car direction is clockwise
-                  if (yellowConeCenter != 1 && carDirection == 1) {
-                    // Set yellowConeCenter as 1 because it has detected a cone
-                    yellowConeCenter = 1;
-
-                    // Turn left when a yellow cone is detected, to steer away from the cone
-                    steeringWheelAngle = steeringWheelAngle - carTurnL;
-                    // std::cout << "line 368 " << steeringWheelAngle << std::endl;
-
-                  } // If a yellow cone has not been detected yet AND car direction is counterclockwise 
-                  else if (yellowConeCenter != 1 && carDirection == -1) {
-                    // Set yellowConeCenter as 1 because it has detected a cone
-                    yellowConeCenter = 1;
-
-                    // Turn right when a yellow cone is detected, to steer away from the cone
-                    steeringWheelAngle = steeringWheelAngle - carTurnR;
-                    //std::cout << "line 378 " << steeringWheelAngle << std::endl;
-                  }
-
-                } // If the current steering angle is less than steeringMin or more than steeringMax
-                else {
-                  // Set steeringWheelAngle to 0 (go straight, no new steering angle provided by driver)
-                  yellowConeCenter = 1;
-                  steeringWheelAngle = 0.0;
-                  //std::cout << "line 386 " << steeringWheelAngle << std::endl;
-                }
-              }
-            }
-            // Pop up window used for testing
-            // If verbose is included in the command line, a window showing only the yellow contours will appear
-            if (VERBOSE) {
-              cv::imshow("Yellow Contours", yellowContourImage);
-              cv::waitKey(1);
-            }
-
-            // If no blue or yellow cones have been detected
-            if (yellowConeCenter == 0 && blueConeCenter == 0) {
-              // If no cones are present, the steeringWheelAngle is set to 0
-              steeringWheelAngle = 0.00;
-              // std::cout << "line 401 " << steeringWheelAngle << std::endl;
-            }
-          }
+          overlay.draw(img, steeringWheelAngle, gsr.groundSteering(), sMicro);
         }
 
-        // creates string stream input, optimized buffer, convert whatever is coming in as string
-        std::ostringstream calcGroundSteering;
-        std::ostringstream actualSteering;
-        std::ostringstream timestamp;
-
-        // putting values into stream
-        calcGroundSteering << steeringWheelAngle;
-        actualSteering << gsr.groundSteering();
-        timestamp << sMicro;
-
-        // creating strings for printing
-        std::string time = " Time Stamp: ";
-        std::string calculatedGroundSteering = "Calculated Ground Steering: ";
-        std::string actualGroundSteering = " Actual Ground Steering: ";
-        std::string groundSteeringAngle = std::to_string(steeringWheelAngle);
-
-        // appending into one string to display
-        calculatedGroundSteering.append(groundSteeringAngle);
-        calculatedGroundSteering.append(calcGroundSteering.str());
-        calculatedGroundSteering.append(actualGroundSteering);
-        calculatedGroundSteering.append(actualSteering.str());
-        calculatedGroundSteering.append(time);
-        calculatedGroundSteering.append(timestamp.str());
-
-        // Displays information on video
-        cv::putText(img, //target image
-          calculatedGroundSteering,
-          cv::Point(1, 50),
-          cv::FONT_HERSHEY_DUPLEX,
-          0.35,
-          CV_RGB(0, 250, 154));
-
         {
-          std::lock_guard < std::mutex > lck(gsrMutex);
-          std::cout << "group_16;" << sMicro << ";" << steeringWheelAngle << std::endl;
-         // std::cout << sMicro << ";" << steeringWheelAngle << ";" << gsr.groundSteering() << " car direction: " << carDirection << std::endl;
+          StageTimer timer {
+            profiler, PipelineStage::STDOUT
+          };
+          console.write(sMicro, steeringWheelAngle);
+        }
+        if (nullptr != latency) {
+          latency -> emitted();
         }
+        if ((nullptr != deadline) && processed && deadline -> update(std::chrono::steady_clock::now() - frameStart)) {
+          std::clog << argv[0] << ": Quality of the cone detection changed from '" << DeadlineController::name(deadline -> previousLevel()) << "' to '" << DeadlineController::name(deadline -> level())
+            << "' (change " << deadline -> changes() << ")." << std::endl;
+          detector.setQuality(deadline -> quality());
+        }
+        // std::cout << sMicro << ";" << steeringWheelAngle << ";" << gsr.groundSteering() << " car direction: " << carDirection << std::endl;
 
         // Displays debug window on screen
         if (VERBOSE) {
-          cv::imshow("Debug", img);
-          cv::waitKey(1);
+          debugWindows.show(img);
+        }
+
+        if (nullptr != profiler) {
+          profiler -> reportIfDue(std::clog);
         }
+        if (nullptr != latency) {
+          latency -> reportIfDue(std::clog);
+        }
+        if (Tracer::dumpRequested() && !Tracer::instance().dump()) {
+          std::cerr << argv[0] << ": Failed to write '" << TRACE << "'." << std::endl;
+        }
+
+      }
+
+      if (Tracer::instance().enabled() && !Tracer::instance().dump()) {
+        std::cerr << argv[0] << ": Failed to write '" << TRACE << "'." << std::endl;
+      }
+
+      if (nullptr != latency) {
+        latency -> report(std::clog);
+        std::clog << argv[0] << ": " << latency -> violations() << " of " << latency -> frames() << " frames were older than 150 ms when their steering wheel angle was emitted." << std::endl;
+      }
 
+      if (nullptr != deadline) {
+        deadline -> report(std::clog);
       }
     }
     retCode = 0;
@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define CATCH_CONFIG_MAIN // This tells Catch to provide a main() - only do this in one cpp file
+// The signal handling of catch.hpp v2.11 does not compile with glibc 2.34 and newer
+#define CATCH_CONFIG_NO_POSIX_SIGNALS
+#include "catch.hpp"
+
+#include "specialized-pipeline.hpp"
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// The generic path of ConeSegmentation::detect in full quality, with the same
+// arguments: the mask of inRange, and the mask after blur, dilate and erode.
+static void generic(const cv::Mat &region, const HsvRange &range, cv::Mat &mask, cv::Mat &morphed) {
+  cv::Mat hsv;
+  cv::cvtColor(region, hsv, cv::COLOR_BGR2HSV);
+  cv::inRange(hsv, cv::Scalar(range.minHue, range.minSat, range.minValue), cv::Scalar(range.maxHue, range.maxSat, range.maxValue), mask);
+  cv::GaussianBlur(mask, morphed, cv::Size(5, 5), 0);
+  cv::dilate(morphed, morphed, 0);
+  cv::erode(morphed, morphed, 0);
+}
+
+// Colours with a hue, saturation or value on a bound of range or next to it,
+// and the other two at most one off the range, so that a single rounding
+// difference decides whether they are inside.
+static std::vector<cv::Vec3b> edgeColours(const HsvRange &range) {
+  cv::Mat colours(4096, 4096, CV_8UC3);
+  for (int i{0}; i < (1 << 24); i++) {
+    colours.at<cv::Vec3b>(i >> 12, i & 4095) = cv::Vec3b(static_cast<uint8_t>(i & 255), static_cast<uint8_t>((i >> 8) & 255), static_cast<uint8_t>(i >> 16));
+  }
+  cv::Mat hsv;
+  cv::cvtColor(colours, hsv, cv::COLOR_BGR2HSV);
+  auto near = [](int value, int low, int high) {
+    return (low - 1 <= value) && (value <= high + 1);
+  };
+  auto onEdge = [](int value, int low, int high) {
+    return (std::abs(value - low) <= 1) || (std::abs(value - high) <= 1);
+  };
+  std::vector<cv::Vec3b> edge;
+  for (int i{0}; i < (1 << 24); i++) {
+    const cv::Vec3b &p{hsv.at<cv::Vec3b>(i >> 12, i & 4095)};
+    if (near(p[0], range.minHue, range.maxHue) && near(p[1], range.minSat, range.maxSat) && near(p[2], range.minValue, range.maxValue) &&
+        (onEdge(p[0], range.minHue, range.maxHue) || onEdge(p[1], range.minSat, range.maxSat) || onEdge(p[2], range.minValue, range.maxValue))) {
+      edge.push_back(colours.at<cv::Vec3b>(i >> 12, i & 4095));
+    }
+  }
+  return edge;
+}
+
+// Regions are views into a wider frame, as the regions of interest are.
+struct TestRegion {
+  cv::Mat frame;
+  cv::Mat region;
+
+  explicit TestRegion(const SpecializedKernels &kernels)
+      : frame(kernels.height + 2, kernels.width + 5, CV_8UC(kernels.channels))
+      , region{frame(cv::Rect(3, 1, kernels.width, kernels.height))} {}
+
+  void setColour(int x, int y, const cv::Vec3b &colour, cv::RNG &rng) {
+    uint8_t *pixel{region.ptr<uint8_t>(y) + x * region.channels()};
+    pixel[0] = colour[0];
+    pixel[1] = colour[1];
+    pixel[2] = colour[2];
+    if (4 == region.channels()) {
+      pixel[3] = static_cast<uint8_t>(rng.uniform(0, 256));
+    }
+  }
+};
+
+// Threshold and filter with kernels; both results must be the ones of OpenCV.
+static void requireSameAsGeneric(const SpecializedKernels &kernels, const cv::Mat &region) {
+  cv::Mat mask;
+  cv::Mat morphed;
+  generic(region, kernels.range, mask, morphed);
+  cv::Mat expectedPadded;
+  cv::copyMakeBorder(mask, expectedPadded, specialized::BLUR_RADIUS, specialized::BLUR_RADIUS, specialized::BLUR_RADIUS, specialized::BLUR_RADIUS,
+                     cv::BORDER_REFLECT_101);
+
+  cv::Mat padded;
+  cv::Mat filtered;
+  std::vector<uint8_t> scratch;
+  kernels.threshold(region, padded);
+  kernels.filter(padded, filtered, scratch);
+  REQUIRE(expectedPadded.size() == padded.size());
+  CHECK(0 == cv::countNonZero(padded != expectedPadded));
+  REQUIRE(morphed.size() == filtered.size());
+  CHECK(0 == cv::countNonZero(filtered != morphed));
+}
+
+static std::string nameOf(const SpecializedKernels &kernels) {
+  return std::to_string(kernels.width) + "x" + std::to_string(kernels.height) + ", " + std::to_string(kernels.channels) + " channels, hue " +
+         std::to_string(kernels.range.minHue) + "-" + std::to_string(kernels.range.maxHue);
+}
+
+TEST_CASE("Every kernel is found for its regions only", "[registry]") {
+  REQUIRE(!PipelineRegistry::all().empty());
+  for (const SpecializedKernels &kernels : PipelineRegistry::all()) {
+    INFO(nameOf(kernels));
+    const TestRegion bytes{kernels};
+    CHECK(&kernels == PipelineRegistry::find(bytes.region, kernels.range));
+    // Same size and channels, but not bytes
+    const cv::Mat words(kernels.height, kernels.width, CV_16UC(kernels.channels));
+    CHECK(nullptr == PipelineRegistry::find(words, kernels.range));
+    const cv::Mat floats(kernels.height, kernels.width, CV_32FC(kernels.channels));
+    CHECK(nullptr == PipelineRegistry::find(floats, kernels.range));
+    const cv::Mat wider(kernels.height, kernels.width + 1, CV_8UC(kernels.channels));
+    CHECK(nullptr == PipelineRegistry::find(wider, kernels.range));
+  }
+}
+
+TEST_CASE("Kernels compute the masks of OpenCV on random pixels", "[specialized]") {
+  cv::RNG rng{0x5eed};
+  for (const SpecializedKernels &kernels : PipelineRegistry::all()) {
+    INFO(nameOf(kernels));
+    TestRegion test{kernels};
+    for (int trial{0}; trial < 4; trial++) {
+      rng.fill(test.frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+      requireSameAsGeneric(kernels, test.region);
+    }
+  }
+}
+
+TEST_CASE("Kernels compute the masks of OpenCV on the edges of the HSV ranges", "[specialized]") {
+  using specialized::TrackColours;
+  cv::RNG rng{0xed9e};
+  const std::vector<cv::Vec3b> blueEdge{edgeColours(TrackColours::Blue::range())};
+  const std::vector<cv::Vec3b> yellowEdge{edgeColours(TrackColours::Yellow::range())};
+  REQUIRE(!blueEdge.empty());
+  REQUIRE(!yellowEdge.empty());
+  for (const SpecializedKernels &kernels : PipelineRegistry::all()) {
+    INFO(nameOf(kernels));
+    // The track colours differ in their hue
+    const std::vector<cv::Vec3b> &edge{(kernels.range.minHue == TrackColours::Blue::range().minHue) ? blueEdge : yellowEdge};
+    auto anyEdgeColour = [&edge, &rng]() {
+      return edge[static_cast<std::size_t>(rng.uniform(0, static_cast<int>(edge.size())))];
+    };
+    TestRegion test{kernels};
+    for (int trial{0}; trial < 4; trial++) {
+      for (int y{0}; y < kernels.height; y++) {
+        for (int x{0}; x < kernels.width; x++) {
+          test.setColour(x, y, anyEdgeColour(), rng);
+        }
+      }
+      requireSameAsGeneric(kernels, test.region);
+    }
+    // Blobs of one colour keep shapes through the blur, up to the border
+    for (int trial{0}; trial < 4; trial++) {
+      rng.fill(test.frame, cv::RNG::UNIFORM, cv::Scalar::all(0), cv::Scalar::all(256));
+      for (int blob{0}; blob < 64; blob++) {
+        const cv::Rect rect{cv::Rect(rng.uniform(-8, kernels.width), rng.uniform(-8, kernels.height), rng.uniform(1, 24), rng.uniform(1, 24)) &
+                            cv::Rect(0, 0, kernels.width, kernels.height)};
+        const cv::Vec3b colour{anyEdgeColour()};
+        for (int y{rect.y}; y < rect.y + rect.height; y++) {
+          for (int x{rect.x}; x < rect.x + rect.width; x++) {
+            test.setColour(x, y, colour, rng);
+          }
+        }
+      }
+      requireSameAsGeneric(kernels, test.region);
+    }
+  }
+}
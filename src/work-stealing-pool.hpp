@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2021  Christian Berger
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef WORK_STEALING_POOL_HPP
+#define WORK_STEALING_POOL_HPP
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Runs a batch of independent tasks on a fixed number of threads.
+//
+// Every worker owns a deque of tasks; the tasks are dealt out round-robin up
+// front. A worker takes its next task from the back of its own deque and,
+// once that is empty, steals from the front of the other workers' deques, so
+// long tasks on one worker do not leave the others idle. Tasks of a batch
+// are expected to run for milliseconds or more; a mutex per deque is cheap
+// compared to that.
+class WorkStealingPool {
+ public:
+  using Task = std::function<void()>;
+
+ public:
+  explicit WorkStealingPool(uint32_t numberOfWorkers) noexcept
+      : m_numberOfWorkers{(0 < numberOfWorkers) ? numberOfWorkers : 1} {}
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+  // Run all tasks and return when the last one has finished.
+  void run(std::vector<Task> &&tasks) {
+    std::vector<std::unique_ptr<Queue>> queues;
+    for (uint32_t i{0}; i < m_numberOfWorkers; i++) {
+      queues.emplace_back(new Queue);
+    }
+    for (std::size_t i{0}; i < tasks.size(); i++) {
+      queues[i % queues.size()]->tasks.push_back(std::move(tasks[i]));
+    }
+    tasks.clear();
+
+    std::vector<std::thread> workers;
+    for (uint32_t i{0}; i < m_numberOfWorkers; i++) {
+      workers.emplace_back([&queues, i]() {
+        Task task;
+        while (takeOwn(*queues[i], task) || steal(queues, i, task)) {
+          task();
+        }
+      });
+    }
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  uint32_t numberOfWorkers() const noexcept {
+    return m_numberOfWorkers;
+  }
+
+ private:
+  struct Queue {
+    std::mutex mutex{};
+    std::deque<Task> tasks{};
+  };
+
+  static bool takeOwn(Queue &queue, Task &task) {
+    std::lock_guard<std::mutex> lck(queue.mutex);
+    if (queue.tasks.empty()) {
+      return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+  }
+
+  // No task is added while a batch runs, so a worker may stop once every
+  // other deque was seen empty.
+  static bool steal(std::vector<std::unique_ptr<Queue>> &queues, uint32_t thief, Task &task) {
+    for (std::size_t i{1}; i < queues.size(); i++) {
+      Queue &victim{*queues[(thief + i) % queues.size()]};
+      std::lock_guard<std::mutex> lck(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+      }
+    }
+    return false;
+  }
+
+ private:
+  uint32_t m_numberOfWorkers;
+};
+
+#endif